@@ -1 +1,34 @@
-../emsdk/upstream/emscripten/emcc src/game_logic.cpp src/game_jump.cpp src/game_chase.cpp src/game_fill.cpp src/game_brightness.cpp -o public/game.js -s WASM=1 -s ALLOW_MEMORY_GROWTH=1 -s NO_EXIT_RUNTIME=1 -s EXPORTED_FUNCTIONS=_init_game,_update_game,_set_initial_game,_malloc,_free -s EXPORTED_RUNTIME_METHODS=ccall,cwrap -O2
+EMCC=../emsdk/upstream/emscripten/emcc
+CORE="src/game_logic.cpp src/game_jump.cpp src/game_chase.cpp src/game_fill.cpp src/game_brightness.cpp src/game_bot.cpp src/persist.cpp src/mem_stats.cpp src/trace.cpp"
+
+if [ "$1" = "bench" ]; then
+    # Microbenchmarks for Node: node build/bench.js (and build/bench-simd.js)
+    mkdir -p build
+    $EMCC $CORE tools/bench.cpp -Isrc -o build/bench.js -s ENVIRONMENT=node -O2
+    $EMCC $CORE tools/bench.cpp -Isrc -o build/bench-simd.js -s ENVIRONMENT=node -O2 -msimd128
+    exit
+fi
+
+# `sh build.sh trace` builds the same module with event tracing (window.exportTrace())
+if [ "$1" = "trace" ]; then
+    TRACE_FLAGS="-DPOCHI_TRACE"
+    TRACE_EXPORTS=",_trace_snapshot,_trace_clear"
+fi
+
+# Startup-optimised web build: ES module glue (preloaded from index.html), no
+# filesystem/stdio, a fixed 256 KiB heap and size-optimised code.
+# $1: output .mjs (the .wasm gets the same name), $2: extra compiler flags
+build_module() {
+    $EMCC $CORE $TRACE_FLAGS $2 -o $1 -Oz \
+        -s MODULARIZE=1 -s EXPORT_ES6=1 -s EXPORT_NAME=createGameModule -s ENVIRONMENT=web \
+        -s FILESYSTEM=0 -s MALLOC=emmalloc \
+        -s ALLOW_MEMORY_GROWTH=0 -s INITIAL_MEMORY=262144 -s STACK_SIZE=16384 \
+        -s EXPORTED_FUNCTIONS=_update_game_n,_game_srand,_create_game_state,_destroy_game_state,_game_state_layout,_screen_diff,_mem_stats_snapshot,_malloc,_free$TRACE_EXPORTS \
+        -s EXPORTED_RUNTIME_METHODS=HEAPU8,HEAPU16,HEAP32,HEAPU32
+}
+
+# Baseline for every browser, plus a 128-bit SIMD variant that main.js picks
+# where WebAssembly SIMD is supported (see src/framebuffer_kernels.h)
+build_module public/game.mjs ""
+build_module public/game-simd.mjs "-msimd128"
+ls -l public/game.mjs public/game.wasm public/game-simd.mjs public/game-simd.wasm
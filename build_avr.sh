@@ -0,0 +1,15 @@
+# Cycle-accurate frame benchmark of the core on ATmega328P under simavr.
+# Needs avr-gcc, avr-size and simavr on the PATH.
+CORE="src/game_logic.cpp src/game_jump.cpp src/game_chase.cpp src/game_fill.cpp src/game_brightness.cpp src/game_bot.cpp src/persist.cpp src/mem_stats.cpp src/trace.cpp"
+MCU=atmega328p
+F_CPU=16000000
+
+mkdir -p build
+avr-g++ -std=gnu++11 -Os -mmcu=$MCU -DF_CPU=${F_CPU}UL -fno-exceptions -fno-rtti -fno-threadsafe-statics \
+    -ffunction-sections -fdata-sections -Wl,--gc-sections \
+    -Isrc -Itools/avr/include $CORE tools/avr/avr_bench.cpp -o build/avr_bench.elf || exit 1
+
+# Flash (.text + .data) and static SRAM (.data + .bss) usage
+avr-size --format=avr --mcu=$MCU build/avr_bench.elf 2>/dev/null || avr-size -A build/avr_bench.elf
+
+simavr -m $MCU -f $F_CPU build/avr_bench.elf
@@ -0,0 +1,22 @@
+# Native (host) build of the core logic and the tools in tools/
+CORE="src/game_logic.cpp src/game_jump.cpp src/game_chase.cpp src/game_fill.cpp src/game_brightness.cpp src/game_bot.cpp src/persist.cpp src/mem_stats.cpp src/trace.cpp"
+mkdir -p build
+g++ -std=c++11 -O2 -Wall -Isrc $CORE src/frame_stream.cpp tools/runner.cpp -o build/runner
+g++ -std=c++11 -O2 -Wall -DPOCHI_TRACE -Isrc $CORE src/frame_stream.cpp tools/runner.cpp -o build/runner_trace
+g++ -std=c++11 -O2 -Wall -Isrc $CORE tools/bench.cpp -o build/bench
+g++ -std=c++11 -O2 -Wall -Isrc src/frame_stream.cpp tools/stream_viewer.cpp -o build/stream_viewer
+g++ -std=c++11 -O2 -Wall -Isrc $CORE src/frame_stream.cpp src/replay.cpp tools/replay_tool.cpp -o build/replay_tool
+g++ -std=c++11 -O2 -Wall -pthread -Isrc $CORE tools/handoff_test.cpp -o build/handoff_test
+g++ -std=c++11 -O2 -Wall -DARDUINO_SIM -Isrc -Itools -Itools/arduino/include $CORE src/frame_stream.cpp src/idle_governor.cpp src/led_palette.cpp -x c++ src/simple-dot.ino -x none tools/arduino/arduino_shim.cpp -o build/arduino_sim
+# Fuzzer for update_game() input sequences (standalone driver; see tools/fuzz_update.cpp for libFuzzer)
+g++ -std=c++11 -O1 -g -Wall -fsanitize=address,undefined -fno-sanitize-recover=all -Isrc $CORE tools/fuzz_update.cpp -o build/fuzz_update
+# Spectator fan-out server and its load generator (Linux: epoll)
+g++ -std=c++11 -O2 -Wall -Isrc -Itools src/frame_stream.cpp tools/websocket.cpp tools/spectator_server.cpp -o build/spectator_server
+g++ -std=c++11 -O2 -Wall -Isrc -Itools src/frame_stream.cpp tools/websocket.cpp tools/spectator_load.cpp -o build/spectator_load
+# Framebuffer kernels against their scalar reference, for each backend this host can build
+g++ -std=c++11 -O2 -Wall -Isrc tools/kernel_test.cpp -o build/kernel_test && ./build/kernel_test || exit 1
+g++ -std=c++11 -O2 -Wall -DPOCHI_NO_SIMD -Isrc tools/kernel_test.cpp -o build/kernel_test_scalar && ./build/kernel_test_scalar || exit 1
+case "$(uname -m)" in
+x86_64|i?86)
+    g++ -std=c++11 -O2 -Wall -mssse3 -Isrc tools/kernel_test.cpp -o build/kernel_test_ssse3 && ./build/kernel_test_ssse3 || exit 1 ;;
+esac
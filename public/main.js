@@ -14,11 +14,31 @@ let jump_button_pressed = false;
 const pixels = [];
 
 // --- WASM related variables ---
-let gameStatePtr; // Pointer to GameState struct in WASM memory
-let init_game_wasm;
-let update_game_wasm;
+let Module; // Instance returned by createGameModule()
+let gameStatePtr; // GameState handle from create_game_state()
+let update_game_n_wasm;
+let layout; // GameState size and field offsets, see GameStateLayoutField in game_logic.h
+let shownPtr; // What the grid currently shows, for screen_diff()
+let diffMasksPtr; // One uint16 per row from screen_diff(): bit x set where pixel x changed
 
-// --- Rendering (called from C++ via EM_JS) ---
+// Indices into game_state_layout(), same order as GameStateLayoutField
+const LAYOUT_SIZE = 0;
+const LAYOUT_ALIGN = 1;
+const LAYOUT_SCREEN = 2;
+const LAYOUT_SCORE = 3;
+const LAYOUT_BRIGHTNESS = 4;
+const LAYOUT_PHASE = 5;
+const LAYOUT_SELECTION = 6;
+const LAYOUT_NUM_FIELDS = 7;
+const UPDATE_N_NO_RENDER = 0x02;
+
+// --- Frame pacing ---
+const FRAME_INTERVAL_MS = 25;
+const MAX_CATCHUP_FRAMES = 64; // Cap so a long background stay does not fast-forward forever
+let inputBufferPtr; // Packed button bits for update_game_n (1 bit per frame)
+let lastFrameTime;
+
+// --- Rendering ---
 window.setPixelInGrid = function(x, y, color) {
     if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
         const pixelIndex = y * SCREEN_WIDTH + x;
@@ -30,7 +50,46 @@ window.setPixelInGrid = function(x, y, color) {
     }
 };
 
+// --- Startup timing ---
+// Time-to-first-frame is measured from navigation start (performance.now() == 0)
+// and left in the performance timeline next to the "wasm-ready" mark.
+let firstFrameDrawn = false;
 
+function reportFirstFrame() {
+    firstFrameDrawn = true;
+    performance.mark('first-frame');
+    const ttff = performance.measure('time-to-first-frame', { start: 0, end: 'first-frame' }).duration;
+    const wasmReady = performance.getEntriesByName('wasm-ready')[0].startTime;
+    window.timeToFirstFrame = ttff;
+    console.log(`Time to first frame: ${ttff.toFixed(1)} ms (WASM ready at ${wasmReady.toFixed(1)} ms)`);
+}
+
+// Reads the framebuffer straight out of WASM memory and touches only the
+// pixels screen_diff() reports as changed (one vector compare per row in the
+// SIMD build). The heap views are looked up every time in case the module is
+// built with memory growth again.
+function drawFrame() {
+    if (Module._screen_diff(gameStatePtr, shownPtr, diffMasksPtr) > 0) {
+        const heap = Module.HEAPU8;
+        const masks = Module.HEAPU16;
+        const screen = gameStatePtr + layout[LAYOUT_SCREEN];
+        for (let y = 0; y < SCREEN_HEIGHT; y++) {
+            let mask = masks[(diffMasksPtr >> 1) + y];
+            for (let x = 0; mask; x++, mask >>= 1) {
+                if (mask & 1) window.setPixelInGrid(x, y, heap[screen + y * SCREEN_WIDTH + x]);
+            }
+        }
+    }
+    if (!firstFrameDrawn) reportFirstFrame();
+}
+
+// Current score and brightness, read from the state (call from the console)
+window.gameScore = function() {
+    return Module.HEAP32[(gameStatePtr + layout[LAYOUT_SCORE]) >> 2];
+};
+window.gameBrightness = function() {
+    return Module.HEAPU8[gameStatePtr + layout[LAYOUT_BRIGHTNESS]];
+};
 
 // --- Initialization ---
 function init() {
@@ -88,46 +147,246 @@ function init() {
 
 // --- Game Loop ---
 function gameLoop() {
-    // 1. Update game state and render via WASM
-    // The C++ update_game function now also calls render_screen,
-    // which in turn calls window.setPixelInGrid for each pixel.
-    update_game_wasm(gameStatePtr, jump_button_pressed);
+    // 1. Work out how many frames are due. setTimeout is throttled in background
+    // tabs, so we may owe more than one frame.
+    const now = performance.now();
+    let frames = Math.floor((now - lastFrameTime) / FRAME_INTERVAL_MS);
+    if (frames < 1) frames = 1;
+    if (frames > MAX_CATCHUP_FRAMES) frames = MAX_CATCHUP_FRAMES;
+    lastFrameTime += frames * FRAME_INTERVAL_MS;
+    if (now - lastFrameTime > FRAME_INTERVAL_MS) lastFrameTime = now; // Drop what we could not catch up
+
+    // 2. Update game state in WASM, then draw the framebuffer from its memory.
+    // The button state is held for the whole batch.
+    Module.HEAPU8.fill(jump_button_pressed ? 0xff : 0, inputBufferPtr, inputBufferPtr + MAX_CATCHUP_FRAMES / 8);
+    if (update_game_n_wasm(gameStatePtr, inputBufferPtr, frames, UPDATE_N_NO_RENDER) > 0) {
+        drawFrame();
+    }
 
     // The jump_button_pressed flag is now reset by keyup/mouseup events.
 
-    // 2. Request next frame
+    // 3. Request next frame
     //requestAnimationFrame(gameLoop);
-    setTimeout(gameLoop, 25)
+    setTimeout(gameLoop, FRAME_INTERVAL_MS)
+}
+
+// --- Memory telemetry (call window.memStats() from the console) ---
+const MEM_STATS_FIELDS = [
+    'stack_high_water', 'free_ram', 'heap_current', 'heap_peak', 'heap_allocs', 'heap_failures',
+    'sizeof_game_state', 'sizeof_jump_game', 'sizeof_chase_game', 'sizeof_fill_game',
+    'sizeof_brightness_game', 'sizeof_instance_storage',
+];
+window.memStats = function() {
+    const ptr = Module._mem_stats_snapshot();
+    const stats = {};
+    MEM_STATS_FIELDS.forEach((name, i) => { stats[name] = Module.HEAPU32[(ptr >> 2) + i]; });
+    return stats;
+};
+
+// --- Event trace (build with `sh build.sh trace`, then call window.exportTrace()) ---
+// Same order as TraceEventType in trace.h
+const TRACE_EVENT_NAMES = [
+    'frame', 'frame', 'game_switch', 'game_start', 'game_exit',
+    'phase', 'level', 'spawn', 'collision', 'line_clear',
+];
+const TRACE_FRAME_BEGIN = 0;
+const TRACE_FRAME_END = 1;
+const TRACE_EVENT_SIZE = 8; // ts_us (u32), type (u16), arg (i16)
+
+// Returns the trace as a Chrome trace object and downloads it as trace.json
+// (open it in chrome://tracing or ui.perfetto.dev).
+window.exportTrace = function(download = true) {
+    if (!Module._trace_snapshot) {
+        console.warn("This build has no tracing; rebuild with `sh build.sh trace`.");
+        return null;
+    }
+    const ptr = Module._trace_snapshot();
+    const view = new DataView(Module.HEAPU8.buffer);
+    const count = view.getUint32(ptr, true);
+    const dropped = view.getUint32(ptr + 4, true);
+    const traceEvents = [
+        { name: 'thread_name', ph: 'M', pid: 1, tid: 1, args: { name: 'update_game' } },
+    ];
+    let frameOpen = false;
+    for (let i = 0; i < count; i++) {
+        const at = ptr + 8 + i * TRACE_EVENT_SIZE;
+        const type = view.getUint16(at + 4, true);
+        const event = {
+            name: TRACE_EVENT_NAMES[type] || 'unknown', ph: 'i', s: 't',
+            ts: view.getUint32(at, true), pid: 1, tid: 1, args: { arg: view.getInt16(at + 6, true) },
+        };
+        if (type === TRACE_FRAME_BEGIN) {
+            event.ph = 'B';
+            frameOpen = true;
+        } else if (type === TRACE_FRAME_END) {
+            if (!frameOpen) continue; // Its begin was overwritten in the ring
+            event.ph = 'E';
+            frameOpen = false;
+        }
+        if (event.ph !== 'i') delete event.s;
+        traceEvents.push(event);
+    }
+    const trace = { traceEvents, displayTimeUnit: 'ms', otherData: { dropped } };
+    if (download) {
+        const link = document.createElement('a');
+        link.href = URL.createObjectURL(new Blob([JSON.stringify(trace)], { type: 'application/json' }));
+        link.download = 'trace.json';
+        link.click();
+        URL.revokeObjectURL(link.href);
+    }
+    return trace;
+};
+
+// --- WASM variant ---
+// Engines with fixed-width SIMD get game-simd.mjs/.wasm (built with -msimd128,
+// see src/framebuffer_kernels.h); the rest get game.mjs/.wasm. The probe is the
+// smallest module using a v128 instruction: it only validates where SIMD is
+// supported. index.html runs the same probe to preload the right files.
+const WASM_SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+const WASM_SIMD = WebAssembly.validate(WASM_SIMD_PROBE);
+
+// Resolves to the variant's name and its createGameModule. A deployment
+// without the SIMD build falls back to the baseline one; without either (a
+// checkout where `sh build.sh` has not been run) the promise rejects.
+function loadGameGlue() {
+    const baseline = () => import('./game.mjs').then((glue) => ({ name: 'game', glue }));
+    if (!WASM_SIMD) return baseline();
+    return import('./game-simd.mjs')
+        .then((glue) => ({ name: 'game-simd', glue }))
+        .catch((e) => {
+            console.warn("SIMD build unavailable, using game.mjs:", e);
+            return baseline();
+        });
 }
 
-// --- Start the engine when WASM is ready ---
-var Module = {
-    onRuntimeInitialized: function() {
-        console.log("WASM Runtime Initialized.");
-        init(); // Initialize DOM elements and event listeners
-        
-
-        // Wrap C++ functions
-        init_game_wasm = Module.cwrap('init_game', null, ['number']);
-        update_game_wasm = Module.cwrap('update_game', null, ['number', 'boolean']);
-        set_initial_game_wasm = Module.cwrap('set_initial_game', null, ['number']);
-
-        // Allocate memory for GameState struct on WASM heap.
-        // Even though we don't access it from JS, the C++ code needs it.
-        // The exact size is not critical from JS side, but it must be large enough.
-        // 256 bytes for screen + ~64 for other members.
-        const SIZEOF_GAMESTATE = 320; 
-        gameStatePtr = Module._malloc(SIZEOF_GAMESTATE);
-        
-        if (!gameStatePtr) {
-            console.error("Failed to allocate WASM memory for GameState.");
-            return;
+// --- WASM loading ---
+// The wasm fetch is already in flight from the preload link in index.html;
+// instantiateStreaming compiles it while it downloads. Servers that do not send
+// application/wasm make it throw, so fall back to compiling the whole buffer.
+function instantiateGameWasm(wasmFile, imports) {
+    return fetch(wasmFile, { credentials: 'same-origin' }).then((response) => {
+        if (!WebAssembly.instantiateStreaming) {
+            return response.arrayBuffer().then((bytes) => WebAssembly.instantiate(bytes, imports));
         }
+        const fallback = response.clone();
+        return WebAssembly.instantiateStreaming(response, imports).catch(() =>
+            fallback.arrayBuffer().then((bytes) => WebAssembly.instantiate(bytes, imports)));
+    });
+}
+
+function startGame() {
+    performance.mark('wasm-ready');
+
+    update_game_n_wasm = Module._update_game_n;
 
-        // Initialize game state in WASM (which will also do the initial render)
-        set_initial_game_wasm(gameStatePtr); // Set initial game to JUMP
+    // The struct layout comes from the compiled module itself
+    const layoutPtr = Module._game_state_layout();
+    layout = Array.from(Module.HEAPU32.subarray(layoutPtr >> 2, (layoutPtr >> 2) + LAYOUT_NUM_FIELDS));
+    console.log(`GameState: ${layout[LAYOUT_SIZE]} bytes, align ${layout[LAYOUT_ALIGN]}`);
 
-        console.log("Game initialized. Starting loop.");
-        gameLoop(); // Start the game loop
+    // Seed the game's own random generator (it is deterministic per seed)
+    Module._game_srand((Math.random() * 0xffffffff) >>> 0);
+
+    // Zeroed state with the first game (JUMP) already set up; free with _destroy_game_state
+    gameStatePtr = Module._create_game_state();
+    if (!gameStatePtr) {
+        console.error("Failed to allocate WASM memory for GameState.");
+        return;
     }
-};
\ No newline at end of file
+    inputBufferPtr = Module._malloc(MAX_CATCHUP_FRAMES / 8);
+    shownPtr = Module._malloc(PIXEL_COUNT);
+    diffMasksPtr = Module._malloc(SCREEN_HEIGHT * 2);
+    Module.HEAPU8.fill(0, shownPtr, shownPtr + PIXEL_COUNT); // The grid starts all color 0
+
+    // The first frame after setup only waits for the button to be released and
+    // draws nothing, so run it now and let the loop draw the title right away.
+    Module.HEAPU8.fill(0, inputBufferPtr, inputBufferPtr + MAX_CATCHUP_FRAMES / 8);
+    update_game_n_wasm(gameStatePtr, inputBufferPtr, 1, UPDATE_N_NO_RENDER);
+
+    console.log("Game initialized. Starting loop.");
+    lastFrameTime = performance.now();
+    gameLoop(); // Start the game loop
+}
+
+// --- Prebuilt fallback ---
+// public/prebuilt/ holds an older build, classic game.js glue with the
+// game.wasm it was built with, so a checkout without emsdk still plays. That
+// build renders through window.setPixelInGrid itself and has none of the
+// exports used above (layout, screen_diff, memStats, traces), nor the games'
+// newer features, so the page says which build is running.
+const PREBUILT_GAME_STATE_SIZE = 320; // Large enough for that build's GameState
+
+function showPrebuiltNotice() {
+    const notice = document.createElement('div');
+    notice.id = 'prebuilt-notice';
+    notice.textContent = 'game.mjs が見つからないため、public/prebuilt/ の古いビルドで動いています。' +
+                         '最新のゲームは `sh build.sh` でビルドしてください。';
+    document.getElementById('controls').after(notice);
+}
+
+function startPrebuiltGame() {
+    showPrebuiltNotice();
+    let memory = null; // That glue does not export its heap views, so keep the instance's memory
+    window.Module = {
+        instantiateWasm(imports, receiveInstance) {
+            instantiateGameWasm('prebuilt/game.wasm', imports)
+                .then((result) => {
+                    memory = result.instance.exports.memory;
+                    receiveInstance(result.instance, result.module);
+                })
+                .catch((e) => console.error("Failed to load prebuilt/game.wasm:", e));
+            return {};
+        },
+        onRuntimeInitialized() {
+            const prebuilt = window.Module;
+            const statePtr = prebuilt._malloc(PREBUILT_GAME_STATE_SIZE);
+            if (!statePtr) {
+                console.error("Failed to allocate WASM memory for GameState.");
+                return;
+            }
+            // set_initial_game() only sets a few fields; the rest must start out zero
+            new Uint8Array(memory.buffer).fill(0, statePtr, statePtr + PREBUILT_GAME_STATE_SIZE);
+            prebuilt._set_initial_game(statePtr);
+            const loop = () => {
+                prebuilt._update_game(statePtr, jump_button_pressed ? 1 : 0);
+                setTimeout(loop, FRAME_INTERVAL_MS);
+            };
+            loop();
+        },
+    };
+    const script = document.createElement('script');
+    script.src = 'prebuilt/game.js'; // The wasm comes through instantiateWasm above
+    document.body.appendChild(script);
+}
+
+// --- Start the engine ---
+// The grid and input handlers do not need WASM, so they are set up first.
+init();
+
+loadGameGlue().then(({ name, glue }) => {
+    console.log(`Loading ${name}.wasm`);
+    return glue.default({
+        instantiateWasm(imports, receiveInstance) {
+            instantiateGameWasm(`${name}.wasm`, imports)
+                .then((result) => receiveInstance(result.instance, result.module))
+                .catch((e) => console.error(`Failed to load ${name}.wasm:`, e));
+            return {}; // Exports arrive asynchronously through receiveInstance
+        },
+    }).then((instance) => {
+        Module = instance;
+        startGame();
+    });
+}, (e) => {
+    console.error("No game.mjs (run `sh build.sh`); starting the older prebuilt build instead:", e);
+    startPrebuiltGame();
+});
+
+// --- Offline cache (sw.js precaches the page for instant repeat loads) ---
+// Registered after load so it does not compete with the first visit's downloads.
+if ('serviceWorker' in navigator) {
+    window.addEventListener('load', () => {
+        navigator.serviceWorker.register('sw.js').catch((e) => console.warn("Service worker registration failed:", e));
+    });
+}
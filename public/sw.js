@@ -0,0 +1,63 @@
+// Service worker: precaches the game so repeat visits start without the network.
+//
+// Requests are answered from the cache and refreshed in the background
+// (stale-while-revalidate), so a new build is picked up on the next visit.
+// Bump CACHE_NAME when the list of files changes.
+
+const CACHE_NAME = 'pochi-pochi-v3';
+const PRECACHE_FILES = [
+    './',
+    'index.html',
+    'main.js',
+    'prebuilt/game.js',
+    'prebuilt/game.wasm',
+];
+// Output of `sh build.sh` (see main.js); a checkout that was never built, or
+// was built without the SIMD variant, must still install
+const OPTIONAL_PRECACHE_FILES = [
+    'game.mjs',
+    'game.wasm',
+    'game-simd.mjs',
+    'game-simd.wasm',
+];
+
+self.addEventListener('install', (event) => {
+    event.waitUntil(
+        caches.open(CACHE_NAME)
+            .then((cache) => Promise.all([
+                cache.addAll(PRECACHE_FILES),
+                ...OPTIONAL_PRECACHE_FILES.map((file) => cache.add(file).catch(() => {})),
+            ]))
+            .then(() => self.skipWaiting())
+    );
+});
+
+self.addEventListener('activate', (event) => {
+    // Drop caches from older versions of this worker
+    event.waitUntil(
+        caches.keys()
+            .then((names) => Promise.all(names.filter((name) => name !== CACHE_NAME).map((name) => caches.delete(name))))
+            .then(() => self.clients.claim())
+    );
+});
+
+self.addEventListener('fetch', (event) => {
+    const request = event.request;
+    if (request.method !== 'GET' || new URL(request.url).origin !== self.location.origin) return;
+
+    event.respondWith(
+        caches.open(CACHE_NAME).then((cache) =>
+            cache.match(request, { ignoreSearch: true }).then((cached) => {
+                const refresh = fetch(request).then((response) => {
+                    if (response.ok) cache.put(request, response.clone());
+                    return response;
+                });
+                if (cached) {
+                    event.waitUntil(refresh.catch(() => {}));
+                    return cached;
+                }
+                return refresh;
+            })
+        )
+    );
+});
@@ -0,0 +1,79 @@
+#ifndef COLLISION_MASK_H
+#define COLLISION_MASK_H
+
+#include "game_logic.h"
+#include "framebuffer_kernels.h"
+
+// --- Occupancy bitmask collision ---
+//
+// One uint16_t per screen row, bit x set where something solid is. A game
+// rasterizes its solid objects into a mask every frame, using the same
+// geometry it draws with (and can draw straight from the mask). A hit test
+// is then a bit test, and mask-vs-mask tests AND whole rows at once. Fast
+// movers fill every row they passed through this frame (fill_rows), so they
+// cannot tunnel through a thin target.
+
+static_assert(SCREEN_WIDTH == 16, "CollisionMask stores one row in a uint16_t");
+
+const uint16_t COLLISION_ROW_FULL = 0xFFFF;
+
+static inline uint16_t collision_bit(int x) { return (uint16_t)(1u << x); }
+
+struct CollisionMask {
+    uint16_t rows[SCREEN_HEIGHT];
+
+    void clear() {
+        for (int y = 0; y < SCREEN_HEIGHT; ++y) rows[y] = 0;
+    }
+
+    // Off-screen cells are never solid
+    bool test(int x, int y) const {
+        if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return false;
+        return (rows[y] >> x) & 1;
+    }
+
+    void set(int x, int y) {
+        if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+        rows[y] |= collision_bit(x);
+    }
+
+    void reset(int x, int y) {
+        if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+        rows[y] &= (uint16_t)~collision_bit(x);
+    }
+
+    // ORs bits into every row from y_from to y_to (inclusive, either order), clipped to the screen
+    void fill_rows(int y_from, int y_to, uint16_t bits) {
+        if (y_from > y_to) { int t = y_from; y_from = y_to; y_to = t; }
+        if (y_from < 0) y_from = 0;
+        if (y_to >= SCREEN_HEIGHT) y_to = SCREEN_HEIGHT - 1;
+        for (int y = y_from; y <= y_to; ++y) rows[y] |= bits;
+    }
+
+    // Solid rectangle, clipped to the screen
+    void fill_rect(int x, int y, int w, int h) {
+        if (x < 0) { w += x; x = 0; }
+        if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+        if (w <= 0 || h <= 0) return;
+        uint16_t bits = (uint16_t)(((1u << w) - 1) << x);
+        fill_rows(y, y + h - 1, bits);
+    }
+
+    bool row_full(int y) const { return rows[y] == COLLISION_ROW_FULL; }
+
+    // True if any cell is solid in both masks
+    bool overlaps(const CollisionMask& other) const {
+        uint16_t hit = 0;
+        for (int y = 0; y < SCREEN_HEIGHT; ++y) hit |= rows[y] & other.rows[y];
+        return hit != 0;
+    }
+
+    // Plots every solid cell in one color, a whole row per kernel call
+    void draw(GameState& state, uint8_t color) const {
+        for (int y = 0; y < SCREEN_HEIGHT; ++y) {
+            if (rows[y]) fb_fill_row_mask(state.screen[y], rows[y], color);
+        }
+    }
+};
+
+#endif // COLLISION_MASK_H
@@ -0,0 +1,120 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include "game_logic.h"
+#include <string.h>
+
+// --- Fixed-capacity entity/particle pool ---
+//
+// Structure-of-arrays storage for small moving things (projectiles, particles,
+// trails). Each field is its own array, so a batched pass touches only the
+// bytes it needs, and the whole pool is plain data that clone_into() copies
+// with the game. Positions and velocities are 8.8 fixed point in screen
+// cells, so there is no float math on AVR.
+//
+// Slots come from a free-list, so spawn() and release() are O(1). Passes
+// visit live slots in index order, which keeps updates deterministic.
+// Releasing during a pass is allowed.
+
+typedef int16_t EntityFixed; // 8.8 fixed point, in screen cells
+const int ENTITY_FIXED_SHIFT = 8;
+const uint8_t ENTITY_NONE = 0xFF; // No slot (free-list terminator)
+const uint8_t ENTITY_IMMORTAL = 0; // life value for entities that never expire
+
+static inline EntityFixed entity_fixed(int cells) { return (EntityFixed)(cells << ENTITY_FIXED_SHIFT); }
+
+template <int CAPACITY>
+struct EntityPool {
+    static_assert(CAPACITY > 0 && CAPACITY < ENTITY_NONE, "slot indices are uint8_t");
+
+    // --- Per-entity fields (SoA) ---
+    EntityFixed x[CAPACITY];
+    EntityFixed y[CAPACITY];
+    EntityFixed vx[CAPACITY];
+    EntityFixed vy[CAPACITY];
+    uint8_t life[CAPACITY];  // Frames left; ENTITY_IMMORTAL never expires
+    uint8_t color[CAPACITY];
+
+    // --- Allocation ---
+    uint8_t alive[(CAPACITY + 7) / 8]; // 1 bit per slot
+    uint8_t next_free[CAPACITY];
+    uint8_t free_head;
+    uint8_t count;
+
+    void clear() {
+        memset(alive, 0, sizeof(alive));
+        for (int i = 0; i < CAPACITY; ++i) next_free[i] = (i + 1 < CAPACITY) ? (uint8_t)(i + 1) : ENTITY_NONE;
+        free_head = 0;
+        count = 0;
+    }
+
+    bool is_alive(int i) const { return (alive[i >> 3] >> (i & 7)) & 1; }
+    bool full() const { return free_head == ENTITY_NONE; }
+
+    // Returns the new slot, or -1 if the pool is full
+    int spawn(EntityFixed px, EntityFixed py, EntityFixed pvx, EntityFixed pvy,
+              uint8_t plife, uint8_t pcolor) {
+        if (free_head == ENTITY_NONE) return -1;
+        int i = free_head;
+        free_head = next_free[i];
+        alive[i >> 3] |= (uint8_t)(1 << (i & 7));
+        count++;
+        x[i] = px; y[i] = py; vx[i] = pvx; vy[i] = pvy;
+        life[i] = plife;
+        color[i] = pcolor;
+        return i;
+    }
+
+    void release(int i) {
+        if (!is_alive(i)) return;
+        alive[i >> 3] &= (uint8_t)~(1 << (i & 7));
+        next_free[i] = free_head;
+        free_head = (uint8_t)i;
+        count--;
+    }
+
+    // Iteration over live slots in index order: for (int i = first(); i >= 0; i = next(i))
+    int first() const { return next(-1); }
+    int next(int i) const {
+        for (++i; i < CAPACITY; ++i) {
+            uint8_t bits = alive[i >> 3] >> (i & 7);
+            if (bits & 1) return i;
+            if (!bits) i |= 7; // Rest of this byte is empty
+        }
+        return -1;
+    }
+
+    int cell_x(int i) const { return x[i] >> ENTITY_FIXED_SHIFT; }
+    int cell_y(int i) const { return y[i] >> ENTITY_FIXED_SHIFT; }
+
+    // --- Batched passes ---
+
+    // Moves every live entity by its velocity and ages it; expired ones are released
+    void integrate() {
+        for (int i = first(); i >= 0; i = next(i)) {
+            x[i] += vx[i];
+            y[i] += vy[i];
+            if (life[i] != ENTITY_IMMORTAL && --life[i] == ENTITY_IMMORTAL) release(i);
+        }
+    }
+
+    // Releases entities more than margin cells outside the screen
+    void cull(int margin) {
+        for (int i = first(); i >= 0; i = next(i)) {
+            int cx = cell_x(i), cy = cell_y(i);
+            if (cx < -margin || cy < -margin || cx >= SCREEN_WIDTH + margin || cy >= SCREEN_HEIGHT + margin) {
+                release(i);
+            }
+        }
+    }
+
+    // Plots every on-screen entity in its color
+    void draw(GameState& state) const {
+        for (int i = first(); i >= 0; i = next(i)) {
+            int cx = cell_x(i), cy = cell_y(i);
+            if (cx >= 0 && cy >= 0 && cx < SCREEN_WIDTH && cy < SCREEN_HEIGHT) state.screen[cy][cx] = color[i];
+        }
+    }
+};
+
+#endif // ENTITY_POOL_H
@@ -0,0 +1,87 @@
+#ifndef FRAME_HANDOFF_H
+#define FRAME_HANDOFF_H
+
+#include "game_logic.h"
+#include <atomic>
+#include <string.h>
+
+// --- Lock-free triple buffer (simulation -> output) ---
+//
+// Hands finished frames from the simulation thread to the output thread
+// (LED transfer or host display) without locks, so a slow matrix.show()
+// never stalls the game tick. Exactly one producer and one consumer.
+//
+// The three slots rotate between the producer's back buffer, a shared middle
+// slot and the consumer's front buffer. Publishing swaps back and middle,
+// acquiring swaps middle and front, each with a single atomic exchange, so
+// neither side ever sees a slot the other is still using. If the consumer is
+// slower, older frames are overwritten in the middle slot and skipped.
+//
+// Header-only and needs <atomic>, so it is included only by builds that run
+// two threads (ESP32 sketch, native tools), never by the AVR build.
+
+#define FRAME_HANDOFF_DIRTY 0x04 // Set in middle when it holds an unread frame
+
+struct HandoffFrame {
+    uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH];
+    uint8_t brightness;
+    uint32_t frame;        // Producer's frame number
+    uint32_t published_us; // Producer timestamp, for handoff latency
+};
+
+struct FrameHandoff {
+    HandoffFrame slots[3];
+    std::atomic<uint8_t> middle; // Slot index | FRAME_HANDOFF_DIRTY
+    uint8_t back;                // Owned by the producer
+    uint8_t front;               // Owned by the consumer
+};
+
+static inline void frame_handoff_init(FrameHandoff& handoff) {
+    memset(handoff.slots, 0, sizeof(handoff.slots));
+    handoff.back = 0;
+    handoff.middle.store(1, std::memory_order_relaxed);
+    handoff.front = 2;
+}
+
+// Producer: the slot to fill for the next frame
+static inline HandoffFrame& frame_handoff_back(FrameHandoff& handoff) {
+    return handoff.slots[handoff.back];
+}
+
+// Producer: makes the back slot the newest frame and takes a fresh back slot
+static inline void frame_handoff_publish(FrameHandoff& handoff) {
+    uint8_t old_middle = handoff.middle.exchange(handoff.back | FRAME_HANDOFF_DIRTY, std::memory_order_acq_rel);
+    handoff.back = old_middle & 3;
+}
+
+// Producer: copies a screen and brightness into the back slot and publishes it
+static inline void frame_handoff_publish_screen(FrameHandoff& handoff, const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH],
+                                                uint8_t brightness, uint32_t frame, uint32_t now_us) {
+    HandoffFrame& slot = frame_handoff_back(handoff);
+    memcpy(slot.screen, screen, sizeof(slot.screen));
+    slot.brightness = brightness;
+    slot.frame = frame;
+    slot.published_us = now_us;
+    frame_handoff_publish(handoff);
+}
+
+// Producer: publishes the game's screen at its brightness setting
+static inline void frame_handoff_publish_state(FrameHandoff& handoff, const GameState& state,
+                                               uint32_t frame, uint32_t now_us) {
+    frame_handoff_publish_screen(handoff, state.screen, state.current_brightness, frame, now_us);
+}
+
+// Consumer: returns true if a newer frame was published since the last call;
+// it is then in frame_handoff_front() until the next successful acquire.
+static inline bool frame_handoff_acquire(FrameHandoff& handoff) {
+    if (!(handoff.middle.load(std::memory_order_relaxed) & FRAME_HANDOFF_DIRTY)) return false;
+    uint8_t old_middle = handoff.middle.exchange(handoff.front, std::memory_order_acq_rel);
+    handoff.front = old_middle & 3;
+    return true;
+}
+
+static inline const HandoffFrame& frame_handoff_front(const FrameHandoff& handoff) {
+    return handoff.slots[handoff.front];
+}
+
+#endif // FRAME_HANDOFF_H
@@ -0,0 +1,182 @@
+#include "frame_stream.h"
+#include <string.h>
+
+// --- Bit Packing ---
+struct BitWriter {
+    uint8_t* out;
+    int bit_count;
+};
+
+static void write_bits(BitWriter& writer, uint8_t value, int bits) {
+    for (int b = bits - 1; b >= 0; --b) {
+        int byte_idx = writer.bit_count >> 3;
+        if ((writer.bit_count & 7) == 0) writer.out[byte_idx] = 0;
+        if ((value >> b) & 1) writer.out[byte_idx] |= 0x80 >> (writer.bit_count & 7);
+        writer.bit_count++;
+    }
+}
+
+struct BitReader {
+    const uint8_t* in;
+    int bit_count;
+    int bit_limit;
+};
+
+// Returns -1 when the payload runs out.
+static int read_bits(BitReader& reader, int bits) {
+    if (reader.bit_count + bits > reader.bit_limit) return -1;
+    int value = 0;
+    for (int b = 0; b < bits; ++b) {
+        int bit = (reader.in[reader.bit_count >> 3] >> (7 - (reader.bit_count & 7))) & 1;
+        value = (value << 1) | bit;
+        reader.bit_count++;
+    }
+    return value;
+}
+
+// CRC-8, polynomial 0x07
+static uint8_t crc8(const uint8_t* data, int len) {
+    uint8_t crc = 0;
+    for (int i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// --- Encoder ---
+
+void frame_stream_encoder_init(FrameStreamEncoder& encoder) {
+    memset(encoder.last_sent, 0, sizeof(encoder.last_sent));
+    encoder.seq = 0;
+    frame_stream_request_keyframe(encoder);
+}
+
+void frame_stream_request_keyframe(FrameStreamEncoder& encoder) {
+    encoder.frames_since_keyframe = FRAME_STREAM_KEYFRAME_INTERVAL;
+}
+
+static void write_run(BitWriter& writer, int run) {
+    while (run >= 2) {
+        int chunk = run > 16 ? 16 : run;
+        write_bits(writer, 0, 1);
+        write_bits(writer, chunk - 1, 4);
+        run -= chunk;
+    }
+    if (run == 1) {
+        write_bits(writer, 1, 1); // A lone unchanged pixel is cheaper as a zero literal
+        write_bits(writer, 0, 3);
+    }
+}
+
+int frame_stream_encode(FrameStreamEncoder& encoder, const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH],
+                        uint8_t* packet) {
+    bool keyframe = encoder.frames_since_keyframe >= FRAME_STREAM_KEYFRAME_INTERVAL;
+    encoder.frames_since_keyframe = keyframe ? 1 : encoder.frames_since_keyframe + 1;
+
+    BitWriter writer = {packet + FRAME_STREAM_HEADER_SIZE, 0};
+    int run = 0;
+    for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+        for (int c = 0; c < SCREEN_WIDTH; ++c) {
+            uint8_t& packed = encoder.last_sent[r][c >> 1];
+            int shift = (c & 1) * 4;
+            uint8_t previous = keyframe ? 0 : (packed >> shift) & 0x0F;
+            uint8_t pixel = screen[r][c] & 0x07;
+            packed = (uint8_t)((packed & ~(0x0F << shift)) | (pixel << shift));
+
+            uint8_t diff = pixel ^ previous;
+            if (diff == 0) {
+                run++;
+                continue;
+            }
+            write_run(writer, run);
+            run = 0;
+            write_bits(writer, 1, 1);
+            write_bits(writer, diff, 3);
+        }
+    }
+    write_run(writer, run);
+
+    int payload_len = (writer.bit_count + 7) >> 3;
+    packet[0] = FRAME_STREAM_SYNC;
+    packet[1] = keyframe ? FRAME_STREAM_KEYFRAME : FRAME_STREAM_DELTA;
+    packet[2] = encoder.seq++;
+    packet[3] = (uint8_t)payload_len;
+    int len = FRAME_STREAM_HEADER_SIZE + payload_len;
+    packet[len] = crc8(packet + 1, len - 1);
+    return len + 1;
+}
+
+// --- Decoder ---
+
+void frame_stream_decoder_init(FrameStreamDecoder& decoder) {
+    memset(&decoder, 0, sizeof(decoder));
+}
+
+// Applies a complete, CRC-checked packet. Returns false if it cannot be used.
+static bool apply_packet(FrameStreamDecoder& decoder) {
+    uint8_t type = decoder.packet[1];
+    uint8_t seq = decoder.packet[2];
+    bool keyframe = (type == FRAME_STREAM_KEYFRAME);
+    if (!keyframe && (!decoder.has_keyframe || seq != decoder.expected_seq)) {
+        decoder.has_keyframe = false; // Lost a packet: wait for the next keyframe
+        return false;
+    }
+
+    uint8_t next[SCREEN_HEIGHT][SCREEN_WIDTH];
+    if (keyframe) memset(next, 0, sizeof(next));
+    else memcpy(next, decoder.screen, sizeof(next));
+
+    BitReader reader = {decoder.packet + FRAME_STREAM_HEADER_SIZE, 0, decoder.packet[3] * 8};
+    uint8_t* pixels = &next[0][0];
+    int pos = 0;
+    while (pos < SCREEN_WIDTH * SCREEN_HEIGHT) {
+        int flag = read_bits(reader, 1);
+        if (flag < 0) return false;
+        if (flag) {
+            int diff = read_bits(reader, 3);
+            if (diff < 0) return false;
+            pixels[pos++] ^= (uint8_t)diff;
+        } else {
+            int run = read_bits(reader, 4);
+            if (run < 0) return false;
+            pos += run + 1;
+        }
+    }
+    if (pos != SCREEN_WIDTH * SCREEN_HEIGHT) return false;
+
+    memcpy(decoder.screen, next, sizeof(next));
+    decoder.has_keyframe = true;
+    decoder.expected_seq = (uint8_t)(seq + 1);
+    decoder.frames++;
+    if (keyframe) decoder.keyframes++;
+    return true;
+}
+
+bool frame_stream_decode_byte(FrameStreamDecoder& decoder, uint8_t byte) {
+    if (decoder.packet_len == 0 && byte != FRAME_STREAM_SYNC) return false; // Hunting for sync
+    decoder.packet[decoder.packet_len++] = byte;
+
+    if (decoder.packet_len == FRAME_STREAM_HEADER_SIZE) {
+        uint8_t type = decoder.packet[1];
+        if ((type != FRAME_STREAM_KEYFRAME && type != FRAME_STREAM_DELTA) ||
+            decoder.packet[3] > FRAME_STREAM_MAX_PAYLOAD) {
+            decoder.packet_len = 0; // Not a real header, resync
+            decoder.dropped++;
+        }
+        return false;
+    }
+    if (decoder.packet_len < FRAME_STREAM_HEADER_SIZE) return false;
+
+    int total = FRAME_STREAM_HEADER_SIZE + decoder.packet[3] + 1;
+    if (decoder.packet_len < total) return false;
+
+    decoder.packet_len = 0;
+    if (crc8(decoder.packet + 1, total - 2) != decoder.packet[total - 1] || !apply_packet(decoder)) {
+        decoder.dropped++;
+        return false;
+    }
+    return true;
+}
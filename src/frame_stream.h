@@ -0,0 +1,54 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include "game_logic.h"
+
+// --- Compact framebuffer stream (board -> host mirroring) ---
+//
+// Packet: 0xA5, type ('K' keyframe / 'D' delta), seq, payload length,
+//         payload, CRC-8 of everything after the sync byte.
+// Payload: MSB-first bit stream of tokens over the 256 pixels in row order,
+//          each pixel XORed with the previously sent frame (black for keyframes):
+//            0 + 4 bits  run of 1..16 unchanged pixels
+//            1 + 3 bits  single pixel, 3-bit XOR value (also used for lone
+//                        unchanged pixels, which keeps every pixel <= 4 bits)
+// A worst-case frame is 128 payload bytes, so a packet always fits in 133 bytes.
+
+#define FRAME_STREAM_SYNC 0xA5
+#define FRAME_STREAM_KEYFRAME 'K'
+#define FRAME_STREAM_DELTA 'D'
+#define FRAME_STREAM_HEADER_SIZE 4
+#define FRAME_STREAM_MAX_PAYLOAD (SCREEN_WIDTH * SCREEN_HEIGHT / 2)
+#define FRAME_STREAM_MAX_PACKET (FRAME_STREAM_HEADER_SIZE + FRAME_STREAM_MAX_PAYLOAD + 1)
+#define FRAME_STREAM_KEYFRAME_INTERVAL 60 // Frames between forced keyframes (~1 s)
+
+struct FrameStreamEncoder {
+    uint8_t last_sent[SCREEN_HEIGHT][SCREEN_WIDTH / 2]; // 4 bits per pixel to save SRAM
+    uint8_t seq;
+    uint16_t frames_since_keyframe;
+};
+
+struct FrameStreamDecoder {
+    uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH];
+    bool has_keyframe;       // Deltas are ignored until the first keyframe
+    uint8_t expected_seq;
+    uint8_t packet[FRAME_STREAM_MAX_PACKET];
+    int packet_len;
+    // Statistics
+    uint32_t frames;
+    uint32_t keyframes;
+    uint32_t dropped;        // Corrupt packets and deltas after a lost packet
+};
+
+// Encoder: writes one packet for `screen` and returns its length.
+void frame_stream_encoder_init(FrameStreamEncoder& encoder);
+void frame_stream_request_keyframe(FrameStreamEncoder& encoder);
+int frame_stream_encode(FrameStreamEncoder& encoder, const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH],
+                        uint8_t* packet);
+
+// Decoder: feed received bytes one at a time. Returns true when a frame was
+// completed and decoder.screen holds it.
+void frame_stream_decoder_init(FrameStreamDecoder& decoder);
+bool frame_stream_decode_byte(FrameStreamDecoder& decoder, uint8_t byte);
+
+#endif // FRAME_STREAM_H
@@ -0,0 +1,207 @@
+#ifndef FRAMEBUFFER_KERNELS_H
+#define FRAMEBUFFER_KERNELS_H
+
+#include "game_logic.h"
+#include <string.h>
+
+// --- Framebuffer row kernels ---
+//
+// A screen row is 16 one-byte pixels, exactly one 128-bit vector, so every
+// kernel here works on whole rows:
+//   fb_fill_rows      rows of one colour (clear, line-clear flash)
+//   fb_fill_row_mask  colour where a 16-bit row mask is set (CollisionMask::draw)
+//   fb_diff_row       16-bit mask of pixels that differ between two rows
+//   fb_palette_row    out[x] = lut[row[x] & 15], a byte shuffle
+//   fb_blit_row       copy src over dst except where src is the transparent index
+// Backends, picked at compile time: wasm_simd128 (emcc -msimd128), SSE2 (all
+// x86-64; the palette lookup needs SSSE3's PSHUFB, else it stays scalar), NEON,
+// or scalar (AVR, ESP32, -DPOCHI_NO_SIMD). The scalar versions are always available as
+// fb_scalar_* so benchmarks can compare, and every backend must give the same
+// bytes as the scalar one. Rows may be unaligned.
+
+static_assert(SCREEN_WIDTH == 16, "The framebuffer kernels handle a row as one 16-byte vector");
+
+#if !defined(POCHI_NO_SIMD) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define FB_SIMD_WASM 1
+#define FB_KERNELS_BACKEND "wasm_simd128"
+#elif !defined(POCHI_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define FB_SIMD_SSE2 1
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#define FB_KERNELS_BACKEND "sse2+ssse3"
+#else
+#define FB_KERNELS_BACKEND "sse2"
+#endif
+#elif !defined(POCHI_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define FB_SIMD_NEON 1
+#define FB_KERNELS_BACKEND "neon"
+#else
+#define FB_KERNELS_BACKEND "scalar"
+#endif
+
+// --- Scalar reference ---
+static inline void fb_scalar_fill_rows(uint8_t* rows, int count, uint8_t color) {
+    memset(rows, color, (size_t)count * SCREEN_WIDTH);
+}
+
+static inline void fb_scalar_fill_row_mask(uint8_t* row, uint16_t mask, uint8_t color) {
+    for (int x = 0; mask; ++x, mask >>= 1) {
+        if (mask & 1) row[x] = color;
+    }
+}
+
+static inline uint16_t fb_scalar_diff_row(const uint8_t* a, const uint8_t* b) {
+    uint16_t mask = 0;
+    for (int x = 0; x < SCREEN_WIDTH; ++x) {
+        if (a[x] != b[x]) mask |= (uint16_t)(1u << x);
+    }
+    return mask;
+}
+
+static inline void fb_scalar_palette_row(const uint8_t* row, const uint8_t lut[16], uint8_t* out) {
+    for (int x = 0; x < SCREEN_WIDTH; ++x) out[x] = lut[row[x] & 15];
+}
+
+static inline void fb_scalar_blit_row(uint8_t* dst, const uint8_t* src, uint8_t transparent) {
+    for (int x = 0; x < SCREEN_WIDTH; ++x) {
+        if (src[x] != transparent) dst[x] = src[x];
+    }
+}
+
+#if defined(FB_SIMD_WASM)
+// --- WebAssembly SIMD ---
+static inline void fb_fill_rows(uint8_t* rows, int count, uint8_t color) {
+    v128_t v = wasm_i8x16_splat((int8_t)color);
+    for (int i = 0; i < count; ++i) wasm_v128_store(rows + i * SCREEN_WIDTH, v);
+}
+
+// Byte x of the result is 0xFF where bit x of mask is set
+static inline v128_t fb_expand_mask(uint16_t mask) {
+    const v128_t bits = wasm_u8x16_const(1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128);
+    v128_t v = wasm_u64x2_make((mask & 0xFF) * 0x0101010101010101ull, (mask >> 8) * 0x0101010101010101ull);
+    return wasm_i8x16_eq(wasm_v128_and(v, bits), bits);
+}
+
+static inline void fb_fill_row_mask(uint8_t* row, uint16_t mask, uint8_t color) {
+    v128_t pixels = wasm_v128_load(row);
+    wasm_v128_store(row, wasm_v128_bitselect(wasm_i8x16_splat((int8_t)color), pixels, fb_expand_mask(mask)));
+}
+
+static inline uint16_t fb_diff_row(const uint8_t* a, const uint8_t* b) {
+    return (uint16_t)wasm_i8x16_bitmask(wasm_i8x16_ne(wasm_v128_load(a), wasm_v128_load(b)));
+}
+
+static inline void fb_palette_row(const uint8_t* row, const uint8_t lut[16], uint8_t* out) {
+    v128_t index = wasm_v128_and(wasm_v128_load(row), wasm_i8x16_splat(15));
+    wasm_v128_store(out, wasm_i8x16_swizzle(wasm_v128_load(lut), index));
+}
+
+static inline void fb_blit_row(uint8_t* dst, const uint8_t* src, uint8_t transparent) {
+    v128_t s = wasm_v128_load(src);
+    v128_t keep = wasm_i8x16_eq(s, wasm_i8x16_splat((int8_t)transparent));
+    wasm_v128_store(dst, wasm_v128_bitselect(wasm_v128_load(dst), s, keep));
+}
+
+#elif defined(FB_SIMD_SSE2)
+// --- SSE2 ---
+static inline void fb_fill_rows(uint8_t* rows, int count, uint8_t color) {
+    __m128i v = _mm_set1_epi8((char)color);
+    for (int i = 0; i < count; ++i) _mm_storeu_si128((__m128i*)(rows + i * SCREEN_WIDTH), v);
+}
+
+static inline __m128i fb_select(__m128i mask, __m128i if_set, __m128i if_clear) {
+    return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+}
+
+// Byte x of the result is 0xFF where bit x of mask is set
+static inline __m128i fb_expand_mask(uint16_t mask) {
+    const __m128i bits = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    __m128i v = _mm_set_epi64x((long long)((mask >> 8) * 0x0101010101010101ull),
+                               (long long)((mask & 0xFF) * 0x0101010101010101ull));
+    return _mm_cmpeq_epi8(_mm_and_si128(v, bits), bits);
+}
+
+static inline void fb_fill_row_mask(uint8_t* row, uint16_t mask, uint8_t color) {
+    __m128i pixels = _mm_loadu_si128((const __m128i*)row);
+    _mm_storeu_si128((__m128i*)row, fb_select(fb_expand_mask(mask), _mm_set1_epi8((char)color), pixels));
+}
+
+static inline uint16_t fb_diff_row(const uint8_t* a, const uint8_t* b) {
+    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+    return (uint16_t)(_mm_movemask_epi8(eq) ^ 0xFFFF);
+}
+
+static inline void fb_palette_row(const uint8_t* row, const uint8_t lut[16], uint8_t* out) {
+#ifdef __SSSE3__
+    __m128i index = _mm_and_si128(_mm_loadu_si128((const __m128i*)row), _mm_set1_epi8(15));
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)lut), index));
+#else
+    // SSE2 has no byte shuffle, and 16 compare-selects lose to plain lookups
+    fb_scalar_palette_row(row, lut, out);
+#endif
+}
+
+static inline void fb_blit_row(uint8_t* dst, const uint8_t* src, uint8_t transparent) {
+    __m128i s = _mm_loadu_si128((const __m128i*)src);
+    __m128i keep = _mm_cmpeq_epi8(s, _mm_set1_epi8((char)transparent));
+    _mm_storeu_si128((__m128i*)dst, fb_select(keep, _mm_loadu_si128((const __m128i*)dst), s));
+}
+
+#elif defined(FB_SIMD_NEON)
+// --- NEON ---
+static inline void fb_fill_rows(uint8_t* rows, int count, uint8_t color) {
+    uint8x16_t v = vdupq_n_u8(color);
+    for (int i = 0; i < count; ++i) vst1q_u8(rows + i * SCREEN_WIDTH, v);
+}
+
+static const uint8_t FB_BIT_LANES[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+static inline void fb_fill_row_mask(uint8_t* row, uint16_t mask, uint8_t color) {
+    uint8x16_t v = vcombine_u8(vdup_n_u8((uint8_t)mask), vdup_n_u8((uint8_t)(mask >> 8)));
+    uint8x16_t set = vtstq_u8(v, vld1q_u8(FB_BIT_LANES));
+    vst1q_u8(row, vbslq_u8(set, vdupq_n_u8(color), vld1q_u8(row)));
+}
+
+static inline uint16_t fb_diff_row(const uint8_t* a, const uint8_t* b) {
+    // Each differing lane keeps its bit value; three pairwise adds sum each half
+    uint8x16_t bits = vbicq_u8(vld1q_u8(FB_BIT_LANES), vceqq_u8(vld1q_u8(a), vld1q_u8(b)));
+    uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    return (uint16_t)(vget_lane_u8(sum, 0) | (vget_lane_u8(sum, 1) << 8));
+}
+
+static inline void fb_palette_row(const uint8_t* row, const uint8_t lut[16], uint8_t* out) {
+    uint8x16_t index = vandq_u8(vld1q_u8(row), vdupq_n_u8(15));
+#if defined(__aarch64__)
+    vst1q_u8(out, vqtbl1q_u8(vld1q_u8(lut), index));
+#else
+    uint8x8x2_t table = {{vld1_u8(lut), vld1_u8(lut + 8)}};
+    vst1q_u8(out, vcombine_u8(vtbl2_u8(table, vget_low_u8(index)), vtbl2_u8(table, vget_high_u8(index))));
+#endif
+}
+
+static inline void fb_blit_row(uint8_t* dst, const uint8_t* src, uint8_t transparent) {
+    uint8x16_t s = vld1q_u8(src);
+    vst1q_u8(dst, vbslq_u8(vceqq_u8(s, vdupq_n_u8(transparent)), vld1q_u8(dst), s));
+}
+
+#else
+// --- Scalar ---
+static inline void fb_fill_rows(uint8_t* rows, int count, uint8_t color) { fb_scalar_fill_rows(rows, count, color); }
+static inline void fb_fill_row_mask(uint8_t* row, uint16_t mask, uint8_t color) {
+    fb_scalar_fill_row_mask(row, mask, color);
+}
+static inline uint16_t fb_diff_row(const uint8_t* a, const uint8_t* b) { return fb_scalar_diff_row(a, b); }
+static inline void fb_palette_row(const uint8_t* row, const uint8_t lut[16], uint8_t* out) {
+    fb_scalar_palette_row(row, lut, out);
+}
+static inline void fb_blit_row(uint8_t* dst, const uint8_t* src, uint8_t transparent) {
+    fb_scalar_blit_row(dst, src, transparent);
+}
+#endif
+
+#endif // FRAMEBUFFER_KERNELS_H
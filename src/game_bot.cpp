@@ -0,0 +1,66 @@
+#include "game_bot.h"
+#include "trace.h"
+
+// --- Rollout ---
+// Simulates the running game for `horizon` frames, tapping the button `taps`
+// times every other frame starting at `tap_frame`. Higher results are better:
+// frames survived when the game ends, otherwise the horizon plus score gained.
+// The random generator is rewound afterwards, so every rollout sees the spawns
+// the real game will get and the real game's sequence is left untouched.
+static int simulate(const GameState& state, int tap_frame, int taps, int horizon) {
+    TRACE_SUSPEND(); // The rollout's spawns and collisions never happen on screen
+    uint32_t rng_state = game_rand_state();
+    GameState sim = state;
+    GameInstanceStorage storage;
+    sim.game_instance = state.game_instance->clone_into(storage.bytes);
+
+    int value = horizon + 1;
+    for (int f = 0; f < horizon; ++f) {
+        int since_first_tap = f - tap_frame;
+        bool pressed = since_first_tap >= 0 && since_first_tap < taps * 2 && (since_first_tap & 1) == 0;
+        sim.game_instance->update(sim, pressed);
+        sim.was_button_pressed_last_frame = pressed;
+        if (sim.game_instance->is_game_over()) {
+            value = f;
+            break;
+        }
+    }
+    if (value > horizon) {
+        value = horizon + (sim.score - state.score);
+    }
+
+    sim.game_instance->~IGame();
+    game_srand(rng_state);
+    TRACE_RESUME();
+    return value;
+}
+
+
+// --- Public API ---
+
+bool bot_choose_input(const GameState& state, int budget_frames) {
+    if (!state.game_instance) return false;
+    if (state.current_selection == GAME_BRIGHTNESS_ADJUSTMENT) return false;
+
+    // On the game-over screen, keep tapping so the game returns to the title
+    if (state.game_instance->is_game_over()) {
+        return !state.was_button_pressed_last_frame;
+    }
+
+    // Three rollouts are fixed: no tap, a single tap now and a double tap now
+    // (ChaseGame needs two taps to reach the lane behind the next one).
+    int num_later = budget_frames / BOT_HORIZON_FRAMES - 3;
+    if (num_later < 0) return false;
+
+    int best_wait = simulate(state, 0, 0, BOT_HORIZON_FRAMES);
+    for (int k = 1; k <= num_later; ++k) {
+        int value = simulate(state, k, 1, BOT_HORIZON_FRAMES);
+        if (value > best_wait) best_wait = value;
+    }
+
+    // Only press now if tapping immediately is strictly better than waiting
+    int best_now = simulate(state, 0, 1, BOT_HORIZON_FRAMES);
+    int double_tap = simulate(state, 0, 2, BOT_HORIZON_FRAMES);
+    if (double_tap > best_now) best_now = double_tap;
+    return best_now > best_wait;
+}
@@ -0,0 +1,54 @@
+#ifndef GAME_BOT_H
+#define GAME_BOT_H
+
+#include "game_logic.h"
+#include "game_jump.h"
+#include "game_chase.h"
+#include "game_fill.h"
+#include "game_brightness.h"
+
+// --- Storage for cloned game instances ---
+// Large enough for any IGame subclass, so lookahead never touches the heap.
+#define GAME_SIZE_MAX2(a, b) ((a) > (b) ? (a) : (b))
+#define GAME_INSTANCE_MAX_SIZE \
+    GAME_SIZE_MAX2(GAME_SIZE_MAX2(sizeof(JumpGame), sizeof(ChaseGame)), \
+                   GAME_SIZE_MAX2(sizeof(FillGame), sizeof(BrightnessGame)))
+
+struct GameInstanceStorage {
+    alignas(8) uint8_t bytes[GAME_INSTANCE_MAX_SIZE];
+};
+
+// --- Search Budget ---
+// Total number of simulated frames the bot may spend per real frame.
+#ifndef BOT_DEFAULT_SEARCH_BUDGET
+#ifdef __AVR__
+#define BOT_DEFAULT_SEARCH_BUDGET 120
+#else
+#define BOT_DEFAULT_SEARCH_BUDGET 400
+#endif
+#endif
+
+// --- Attract Mode ---
+// The idle title hands the game to the bot. Each rollout puts a GameState and
+// a cloned instance (~410 bytes on AVR) on the stack on top of the frame's
+// call chain, which an ATmega328P cannot spare next to the 768-byte LED
+// buffer, so the demo is off there. Define ATTRACT_MODE 1 to try it, with
+// the mem stack_hw report watching the headroom.
+#ifndef ATTRACT_MODE
+#ifdef __AVR__
+#define ATTRACT_MODE 0
+#else
+#define ATTRACT_MODE 1
+#endif
+#endif
+
+// Number of frames each candidate button sequence is simulated ahead.
+#define BOT_HORIZON_FRAMES 40
+
+// Picks the button state for the next frame of the running game by simulating
+// "tap on frame k" candidates on clones of the state. Each clone starts from the
+// current game_rand() state and the state is restored after it, so the
+// candidates predict the real spawns and the bot never changes what a seed plays.
+bool bot_choose_input(const GameState& state, int budget_frames);
+
+#endif // GAME_BOT_H
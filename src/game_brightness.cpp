@@ -1,13 +1,18 @@
 #include "game_brightness.h"
 #include <string.h>
-#include <stdio.h> // For sprintf
+#include <stdlib.h> // For abs
+#include <new> // For placement new
 
 // --- Game Constants ---
-const uint8_t BrightnessGame::BRIGHTNESS_LEVELS[] = {0, 4, 8, 16, 32, 64, 128, 255};
+// One stop apart in LED intensity. 1 and 2 are night levels below the old
+// dimmest setting; the LEDs have no finer step than 1.
+const uint8_t BrightnessGame::BRIGHTNESS_LEVELS[] = {0, 1, 2, 4, 8, 16, 32, 64, 128, 255};
 const int BrightnessGame::NUM_BRIGHTNESS_LEVELS = sizeof(BRIGHTNESS_LEVELS) / sizeof(BRIGHTNESS_LEVELS[0]);
 
 const int BRIGHTNESS_DISPLAY_HOLD_FRAMES = 90; // Hold display for 1.5 seconds
 
+const GameTitle BrightnessGame::TITLE = {"BRIGHT", "NESS", 2, 8, 7, glyph_string_length("BRIGHT") * GLYPH_ADVANCE};
+
 // --- Constructor ---
 BrightnessGame::BrightnessGame(GameState& state) {
     state.score = 0; // Not used, but reset
@@ -16,27 +21,37 @@ BrightnessGame::BrightnessGame(GameState& state) {
     m_display_hold_timer = BRIGHTNESS_DISPLAY_HOLD_FRAMES;
 
     // Find current brightness index
-    m_current_brightness_index = 0;
-    for(int i = 0; i < NUM_BRIGHTNESS_LEVELS; ++i) {
-        if (BRIGHTNESS_LEVELS[i] == state.current_brightness) {
-            m_current_brightness_index = i;
-            break;
-        }
-    }
+    m_current_brightness_index = nearest_level_index(state.current_brightness);
 }
 
 // --- Public Methods ---
 
-void BrightnessGame::draw_title(GameState& state) {
-    const char* title_text = "BRIGHT";
-    const char* title_text2 = "NESS";
-
-    state.text_scroll_offset -= 0.5f;
-    if (state.text_scroll_offset < -(float)strlen(title_text) * 6) {
-        state.text_scroll_offset = SCREEN_WIDTH;
+int BrightnessGame::nearest_level_index(uint8_t brightness) {
+    int nearest = 0;
+    for (int i = 1; i < NUM_BRIGHTNESS_LEVELS; ++i) {
+        if (abs(BRIGHTNESS_LEVELS[i] - brightness) < abs(BRIGHTNESS_LEVELS[nearest] - brightness)) nearest = i;
     }
-    draw_text(state, title_text, (int)state.text_scroll_offset, 2, 7); // White
-    draw_text(state, title_text2, (int)state.text_scroll_offset, 8, 7); // White
+    return nearest;
+}
+
+uint8_t BrightnessGame::nearest_level(uint8_t brightness) {
+    return BRIGHTNESS_LEVELS[nearest_level_index(brightness)];
+}
+
+uint8_t BrightnessGame::dimmed_brightness(uint8_t brightness, int steps) {
+    if (brightness == 0) return 0;
+    int index = 1;
+    while (index + 1 < NUM_BRIGHTNESS_LEVELS && BRIGHTNESS_LEVELS[index + 1] <= brightness) index++;
+    index -= steps;
+    return BRIGHTNESS_LEVELS[index < 1 ? 1 : index];
+}
+
+IGame* BrightnessGame::clone_into(void* storage) const {
+    return new (storage) BrightnessGame(*this);
+}
+
+GameplayPhase BrightnessGame::gameplay_phase() const {
+    return GAMEPLAY_PLAYING; // Brightness adjustment has no countdown or game-over screen
 }
 
 
@@ -47,12 +62,13 @@ bool BrightnessGame::update(GameState& state, bool button_pressed) {
     if (m_display_hold_timer > 0) {
         m_display_hold_timer--;
         // Draw brightness value
-        char bright_str[8];
-        sprintf(bright_str, "L%d", m_current_brightness_index);
-        draw_text(state, bright_str, (SCREEN_WIDTH - strlen(bright_str) * 6) / 2, 5, 7); // Centered, white
+        uint8_t glyphs[1 + GLYPH_UINT_MAX_DIGITS];
+        glyphs[0] = glyph_for_char('L');
+        int count = 1 + format_uint_glyphs(glyphs + 1, m_current_brightness_index);
+        draw_glyphs(state, glyphs, count, (SCREEN_WIDTH - count * GLYPH_ADVANCE) / 2, 5, 7, GLYPH_ALIGN_LEFT); // Centered, white
     } else {
         // After hold, revert to title-like behavior (e.g. show "BRIGHTNESS" scrolling)
-        draw_title(state); // Show scrolling title when not actively displaying level
+        draw_game_title(state, GAME_BRIGHTNESS_ADJUSTMENT); // Show scrolling title when not actively displaying level
     }
 
 
@@ -10,12 +10,23 @@ public:
     ~BrightnessGame() = default;
 
     bool update(GameState& state, bool button_pressed) override;
-    void draw_title(GameState& state) override;
+    IGame* clone_into(void* storage) const override;
+
+    static const GameTitle TITLE;
+    GameplayPhase gameplay_phase() const override;
+
+    // Brightness `steps` levels further down BRIGHTNESS_LEVELS, never below the
+    // dimmest visible level (0 stays 0). Used by the idle governor.
+    static uint8_t dimmed_brightness(uint8_t brightness, int steps);
+
+    // The level closest to `brightness`, for values saved with another level table
+    static uint8_t nearest_level(uint8_t brightness);
 
 private:
     // Constants for brightness levels
     static const uint8_t BRIGHTNESS_LEVELS[];
     static const int NUM_BRIGHTNESS_LEVELS;
+    static int nearest_level_index(uint8_t brightness);
 
     int m_frame_counter;
     int m_display_hold_timer; // To keep the BRT value on screen for a bit
@@ -1,7 +1,8 @@
 #include "game_chase.h"
+#include "trace.h"
 #include <string.h>
-#include <stdlib.h> // For rand()
-#include <stdio.h> // For sprintf
+#include <stdlib.h>
+#include <new> // For placement new
 
 // --- Chase Game Constants ---
 const int PLAYER_Y_POS = 14;
@@ -16,6 +17,12 @@ const float WALL_SPEED_LEVELS[] = {0.2f, 0.3f, 0.4f, 0.5f};
 const int WALL_SPACING_LEVELS[] = {8, 7, 6, 5};
 const int SCORE_THRESHOLDS_CHASE[] = {15, 40, 70}; // Score needed to reach Level 1, 2, 3
 
+// A wall fills its whole row except the gap lane
+static uint16_t wall_row_bits(int gap_lane_index) {
+    return COLLISION_ROW_FULL & (uint16_t)~collision_bit(LANE_POS[gap_lane_index]);
+}
+
+const GameTitle ChaseGame::TITLE = {"CHASE", nullptr, 5, 0, CHASE_PLAYER_COLOR, glyph_string_length("CHASE") * GLYPH_ADVANCE};
 
 // --- Constructor ---
 ChaseGame::ChaseGame(GameState& state) {
@@ -32,7 +39,7 @@ ChaseGame::ChaseGame(GameState& state) {
     m_current_wall_spacing = WALL_SPACING_LEVELS[0];
     m_next_difficulty_score_threshold = SCORE_THRESHOLDS_CHASE[0];
 
-    for (int i = 0; i < MAX_OBSTACLES; ++i) {
+    for (int i = 0; i < CHASE_MAX_WALLS; ++i) {
         spawn_wall(m_walls[i], -i * m_current_wall_spacing); // Use current spacing
     }
 }
@@ -40,13 +47,12 @@ ChaseGame::ChaseGame(GameState& state) {
 
 // --- Public Methods ---
 
-void ChaseGame::draw_title(GameState& state) {
-    const char* title_text = "CHASE";
-    state.text_scroll_offset -= 0.5f;
-    if (state.text_scroll_offset < -(float)strlen(title_text) * 6) { // Fix applied here
-        state.text_scroll_offset = SCREEN_WIDTH;
-    }
-    draw_text(state, title_text, (int)state.text_scroll_offset, 5, CHASE_PLAYER_COLOR);
+IGame* ChaseGame::clone_into(void* storage) const {
+    return new (storage) ChaseGame(*this);
+}
+
+GameplayPhase ChaseGame::gameplay_phase() const {
+    return m_phase == CHASE_PHASE_GAMEOVER ? GAMEPLAY_GAMEOVER : GAMEPLAY_PLAYING;
 }
 
 bool ChaseGame::update(GameState& state, bool button_pressed) {
@@ -57,6 +63,7 @@ bool ChaseGame::update(GameState& state, bool button_pressed) {
             // --- Difficulty Scaling ---
             if (m_difficulty_level < MAX_DIFFICULTY_LEVELS - 1 && state.score >= m_next_difficulty_score_threshold) {
                 m_difficulty_level++;
+                TRACE_EVENT(TRACE_LEVEL, m_difficulty_level);
                 m_current_wall_speed = WALL_SPEED_LEVELS[m_difficulty_level];
                 m_current_wall_spacing = WALL_SPACING_LEVELS[m_difficulty_level];
                 if (m_difficulty_level < MAX_DIFFICULTY_LEVELS - 1) { // Ensure we don't access out of bounds
@@ -73,8 +80,16 @@ bool ChaseGame::update(GameState& state, bool button_pressed) {
             }
 
             // --- Update Game State ---
-            for (int i = 0; i < MAX_OBSTACLES; ++i) {
+            // Every row a wall passed through this frame is solid, so even a wall
+            // faster than one row per frame cannot skip over the player's row.
+            CollisionMask swept;
+            swept.clear();
+            for (int i = 0; i < CHASE_MAX_WALLS; ++i) {
+                int prev_y = (int)m_walls[i].y_pos;
                 m_walls[i].y_pos += m_current_wall_speed; // Use current speed
+                int new_y = (int)m_walls[i].y_pos;
+                swept.fill_rows(prev_y + 1 <= new_y ? prev_y + 1 : new_y, new_y,
+                                wall_row_bits(m_walls[i].gap_lane_index));
 
                 if (!m_walls[i].scored && m_walls[i].y_pos > PLAYER_Y_POS) {
                     state.score++;
@@ -88,30 +103,17 @@ bool ChaseGame::update(GameState& state, bool button_pressed) {
 
             // --- Collision Detection ---
             int player_lane_x = LANE_POS[m_player_lane_index];
-            for (int i = 0; i < MAX_OBSTACLES; ++i) {
-                int wall_y = (int)m_walls[i].y_pos;
-                if (wall_y == PLAYER_Y_POS) {
-                    int gap_lane = m_walls[i].gap_lane_index;
-                    if (m_player_lane_index != gap_lane) {
-                        m_phase = CHASE_PHASE_GAMEOVER;
-                        m_frame_counter = 0;
-                        state.text_scroll_offset = SCREEN_WIDTH;
-                    }
-                }
+            if (swept.test(player_lane_x, PLAYER_Y_POS)) {
+                TRACE_EVENT(TRACE_COLLISION, -1);
+                m_phase = CHASE_PHASE_GAMEOVER;
+                m_frame_counter = 0;
+                state.text_scroll_offset = SCREEN_WIDTH;
             }
 
             // --- Drawing ---
-            for (int i = 0; i < MAX_OBSTACLES; ++i) {
-                int wall_y = (int)m_walls[i].y_pos;
-                if (wall_y >= 0 && wall_y < SCREEN_HEIGHT) {
-                    int gap_lane_x = LANE_POS[m_walls[i].gap_lane_index];
-                    for (int x = 0; x < SCREEN_WIDTH; ++x) {
-                        if (x != gap_lane_x) {
-                            state.screen[wall_y][x] = CHASE_WALL_COLOR;
-                        }
-                    }
-                }
-            }
+            CollisionMask walls;
+            rasterize_walls(walls);
+            walls.draw(state, CHASE_WALL_COLOR);
             state.screen[PLAYER_Y_POS][player_lane_x] = CHASE_PLAYER_COLOR;
             break;
         }
@@ -145,6 +147,16 @@ bool ChaseGame::update(GameState& state, bool button_pressed) {
 
 void ChaseGame::spawn_wall(ChaseObstacle& wall, float y_pos) {
     wall.y_pos = y_pos;
-    wall.gap_lane_index = rand() % NUM_LANES;
+    wall.gap_lane_index = game_rand() % NUM_LANES;
     wall.scored = false;
+    TRACE_EVENT(TRACE_SPAWN, wall.gap_lane_index);
+}
+
+// Walls at their current rows (what is drawn this frame)
+void ChaseGame::rasterize_walls(CollisionMask& walls) const {
+    walls.clear();
+    for (int i = 0; i < CHASE_MAX_WALLS; ++i) {
+        int wall_y = (int)m_walls[i].y_pos;
+        walls.fill_rows(wall_y, wall_y, wall_row_bits(m_walls[i].gap_lane_index));
+    }
 }
@@ -2,6 +2,7 @@
 #define GAME_CHASE_H
 
 #include "game_logic.h"
+#include "collision_mask.h"
 
 // --- Internal Phase for the Chase Game ---
 enum ChaseGamePhase {
@@ -10,7 +11,7 @@ enum ChaseGamePhase {
 };
 
 // --- Data Structures ---
-#define MAX_OBSTACLES 2
+const int CHASE_MAX_WALLS = 2;
 struct ChaseObstacle {
     float y_pos;          // vertical position of the wall
     int gap_lane_index;   // the lane where the gap is
@@ -24,13 +25,16 @@ public:
     ~ChaseGame() = default;
 
     bool update(GameState& state, bool button_pressed) override;
-    void draw_title(GameState& state) override;
+    IGame* clone_into(void* storage) const override;
+
+    static const GameTitle TITLE;
+    GameplayPhase gameplay_phase() const override;
 
 private:
     // Game-specific state
     ChaseGamePhase m_phase;
     int m_player_lane_index;
-    ChaseObstacle m_walls[MAX_OBSTACLES]; // Use ChaseObstacle
+    ChaseObstacle m_walls[CHASE_MAX_WALLS]; // Use ChaseObstacle
     int m_frame_counter;
     float m_current_wall_speed;
     int m_current_wall_spacing;
@@ -39,6 +43,7 @@ private:
 
     // Private helper methods
     void spawn_wall(ChaseObstacle& wall, float y_pos); // Update signature
+    void rasterize_walls(CollisionMask& walls) const;
 };
 
 
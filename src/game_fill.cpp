@@ -1,7 +1,8 @@
 #include "game_fill.h"
+#include "trace.h"
 #include <string.h>
 #include <stdlib.h>
-#include <stdio.h>
+#include <new> // For placement new
 
 // --- Game Constants ---
 const int PLAYER_COLOR_FILL = 2; // Green
@@ -14,13 +15,7 @@ const int PLAYFIELD_SHIFT_SPEED_LEVELS[] = {400, 300, 200, 150};
 const int NUM_GAPS_PER_ROW_LEVELS[] = {1, 2, 3, 4}; // More gaps = harder (user's definition)
 const int SCORE_THRESHOLDS[] = {5, 15, 30}; // Score needed to reach Level 1, 2, 3
 
-
-// --- Helper Functions for Bit Packing ---
-
-// Calculate the byte index for a given column
-#define GET_BYTE_INDEX(c) ((c) / 8)
-// Calculate the bit position within that byte
-#define GET_BIT_POS(c)    ((c) % 8)
+const GameTitle FillGame::TITLE = {"FILL", nullptr, 5, 0, 4, glyph_string_length("FILL") * GLYPH_ADVANCE};
 
 // --- Constructor ---
 FillGame::FillGame(GameState& state) {
@@ -30,7 +25,7 @@ FillGame::FillGame(GameState& state) {
     m_phase = FILL_PHASE_PLAYING;
     m_frame_counter = 0;
 
-    memset(m_playfield, 0, sizeof(m_playfield)); // Initialize all bits to 0 (false)
+    m_playfield.clear();
 
     // Initialize difficulty parameters
     m_difficulty_level = 0;
@@ -41,13 +36,7 @@ FillGame::FillGame(GameState& state) {
 
     // Generate initial 5 rows
     for (int r = 0; r < 5; ++r) {
-        // Shift existing blocks down to make space for the new top row
-        for (int row_idx = SCREEN_HEIGHT - 2; row_idx >= 0; --row_idx) {
-            // Shift bit-packed rows
-            for(int byte_idx = 0; byte_idx < (SCREEN_WIDTH / 8); ++byte_idx) {
-                m_playfield[row_idx + 1][byte_idx] = m_playfield[row_idx][byte_idx];
-            }
-        }
+        shift_playfield_down(); // Make space for the new top row
         generate_new_top_row(); // Generates a new row at the very top (row 0)
     }
 
@@ -56,20 +45,22 @@ FillGame::FillGame(GameState& state) {
     m_playfield_shift_timer = PLAYFIELD_SHIFT_SPEED_LEVELS[0]; // Initialize with level 0 speed
     m_line_clear_timer = 0;
     m_line_clear_y = -1;
-    for (int i = 0; i < MAX_PROJECTILES; ++i) {
-        m_projectiles[i].active = false;
-    }
+    m_projectiles.clear();
 }
 
 // --- Public Methods ---
 
-void FillGame::draw_title(GameState& state) {
-    const char* title_text = "FILL";
-    state.text_scroll_offset -= 0.5f;
-    if (state.text_scroll_offset < -(float)strlen(title_text) * 6) {
-        state.text_scroll_offset = SCREEN_WIDTH;
+IGame* FillGame::clone_into(void* storage) const {
+    return new (storage) FillGame(*this);
+}
+
+GameplayPhase FillGame::gameplay_phase() const {
+    switch (m_phase) {
+        case FILL_PHASE_COUNTDOWN: return GAMEPLAY_COUNTDOWN;
+        case FILL_PHASE_PLAYING: return GAMEPLAY_PLAYING;
+        case FILL_PHASE_GAMEOVER: break;
     }
-    draw_text(state, title_text, (int)state.text_scroll_offset, 5, 4); // Original color
+    return GAMEPLAY_GAMEOVER;
 }
 
 bool FillGame::update(GameState& state, bool button_pressed) {
@@ -93,15 +84,9 @@ bool FillGame::update(GameState& state, bool button_pressed) {
             if (m_line_clear_timer > 0) {
                 m_line_clear_timer--;
                 if (m_line_clear_timer == 0) {
-                    // Clear the cleared line itself
-                    for(int c = 0; c < SCREEN_WIDTH; ++c) {
-                        set_pixel_status(m_line_clear_y, c, false);
-                    }
-                    // Clear all rows below the cleared line as a bonus
-                    for (int r = m_line_clear_y + 1; r < SCREEN_HEIGHT; r++) {
-                        for(int c = 0; c < SCREEN_WIDTH; ++c) {
-                            set_pixel_status(r, c, false);
-                        }
+                    // Clear the cleared line itself, and all rows below it as a bonus
+                    for (int r = m_line_clear_y; r < SCREEN_HEIGHT; r++) {
+                        m_playfield.rows[r] = 0;
                     }
                     m_line_clear_y = -1;
                 }
@@ -111,6 +96,7 @@ bool FillGame::update(GameState& state, bool button_pressed) {
                 // --- Difficulty Scaling ---
                 if (m_difficulty_level < 3 && state.score >= m_next_difficulty_score_threshold) {
                     m_difficulty_level++;
+                    TRACE_EVENT(TRACE_LEVEL, m_difficulty_level);
                     m_current_playfield_shift_speed = PLAYFIELD_SHIFT_SPEED_LEVELS[m_difficulty_level];
                     m_current_player_move_speed = PLAYER_MOVE_SPEED_LEVELS[m_difficulty_level];
                     m_num_gaps_per_row = NUM_GAPS_PER_ROW_LEVELS[m_difficulty_level];
@@ -130,88 +116,58 @@ bool FillGame::update(GameState& state, bool button_pressed) {
 
                 // --- Fire Projectile ---
                 if (button_pressed && !state.was_button_pressed_last_frame) {
-                    for (int i = 0; i < MAX_PROJECTILES; ++i) {
-                        if (!m_projectiles[i].active) {
-                            m_projectiles[i].active = true;
-                            m_projectiles[i].x = m_player_x;
-                            m_projectiles[i].y = SCREEN_HEIGHT - 2;
-                            break; // Exit after firing one projectile per button press
-                        }
+                    // One projectile per button press, moving up one cell per frame (ignored if the pool is full)
+                    if (m_projectiles.spawn(entity_fixed(m_player_x), entity_fixed(SCREEN_HEIGHT - 2),
+                                            0, -entity_fixed(1), ENTITY_IMMORTAL, PROJECTILE_COLOR) >= 0) {
+                        TRACE_EVENT(TRACE_SPAWN, m_player_x);
                     }
                 }
 
                 // --- Update Projectiles ---
-                for (int i = 0; i < MAX_PROJECTILES; ++i) {
-                    if (m_projectiles[i].active) {
-                        if (m_projectiles[i].y < 0 || get_pixel_status(m_projectiles[i].y, m_projectiles[i].x)) { // Use helper
-                            int final_y = m_projectiles[i].y + 1;
-                            if (final_y < SCREEN_HEIGHT) {
-                                set_pixel_status(final_y, m_projectiles[i].x, true); // Use helper
-                                bool line_full = true;
-                                for(int c = 0; c < SCREEN_WIDTH; c++) {
-                                    if (!get_pixel_status(final_y, c)) { // Use helper
-                                        line_full = false;
-                                        break;
-                                    }
-                                }
-                                if (line_full) {
-                                    state.score += 1;
-                                    m_line_clear_timer = 15;
-                                    m_line_clear_y = final_y;
-                                    // Draw line clear effect directly, m_playfield doesn't store color
-                                }
+                // Landing is checked for all projectiles first, then the survivors move together
+                for (int i = m_projectiles.first(); i >= 0; i = m_projectiles.next(i)) {
+                    int x = m_projectiles.cell_x(i);
+                    int y = m_projectiles.cell_y(i);
+                    if (y < 0 || m_playfield.test(x, y)) {
+                        int final_y = y + 1;
+                        if (final_y < SCREEN_HEIGHT) {
+                            TRACE_EVENT(TRACE_COLLISION, final_y);
+                            m_playfield.set(x, final_y);
+                            if (m_playfield.row_full(final_y)) {
+                                TRACE_EVENT(TRACE_LINE_CLEAR, final_y);
+                                state.score += 1;
+                                m_line_clear_timer = 15;
+                                m_line_clear_y = final_y;
+                                // Draw line clear effect directly, m_playfield doesn't store color
                             }
-                            m_projectiles[i].active = false;
-                        } else {
-                             m_projectiles[i].y--;
                         }
+                        m_projectiles.release(i);
                     }
                 }
+                m_projectiles.integrate();
                 
                 // --- Shift Playfield ---
                 m_playfield_shift_timer++;
                 if (m_playfield_shift_timer >= m_current_playfield_shift_speed) { // Use current speed
                     m_playfield_shift_timer = 0;
-                    for (int i = 0; i < SCREEN_WIDTH; i++) {
-                        if (get_pixel_status(SCREEN_HEIGHT - 1, i)) { // Use helper
-                            m_phase = FILL_PHASE_GAMEOVER;
-                            m_frame_counter = 0;
-                            break;
-                        }
+                    if (m_playfield.rows[SCREEN_HEIGHT - 1] != 0) { // A block would be pushed off the bottom
+                        m_phase = FILL_PHASE_GAMEOVER;
+                        m_frame_counter = 0;
+                        break;
                     }
-                    if (m_phase == FILL_PHASE_GAMEOVER) break;
 
-                    // Shift bit-packed rows down
-                    for (int r = SCREEN_HEIGHT - 2; r >= 0; r--) {
-                        for(int byte_idx = 0; byte_idx < (SCREEN_WIDTH / 8); ++byte_idx) {
-                            m_playfield[r + 1][byte_idx] = m_playfield[r][byte_idx];
-                        }
-                    }
+                    shift_playfield_down();
                     generate_new_top_row();
                 }
             }
             // --- Drawing ---
-            for (int r = 0; r < SCREEN_HEIGHT; ++r) {
-                for (int c = 0; c < SCREEN_WIDTH; ++c) {
-                    uint8_t pixel_color = 0;
-                    if (get_pixel_status(r, c)) { // If there's a block
-                        pixel_color = STATIC_BLOCK_COLOR;
-                    }
-
-                    // Check for line clear effect
-                    if (m_line_clear_timer > 0 && r == m_line_clear_y) {
-                        pixel_color = LINE_CLEAR_EFFECT_COLOR;
-                    }
-                    state.screen[r][c] = pixel_color;
-                }
+            m_playfield.draw(state, STATIC_BLOCK_COLOR);
+            if (m_line_clear_timer > 0) { // Line clear effect over the whole row
+                fb_fill_rows(state.screen[m_line_clear_y], 1, LINE_CLEAR_EFFECT_COLOR);
             }
 
-            // Draw projectiles
-            for (int i = 0; i < MAX_PROJECTILES; ++i) {
-                if (m_projectiles[i].active) {
-                    state.screen[m_projectiles[i].y][m_projectiles[i].x] = PROJECTILE_COLOR;
-                }
-            }
+            // Draw projectiles (one that flew past the top row stays alive off-screen for a frame)
+            m_projectiles.draw(state);
             state.screen[SCREEN_HEIGHT - 1][m_player_x] = PLAYER_COLOR_FILL;
             break;
         }
@@ -240,32 +196,14 @@ bool FillGame::update(GameState& state, bool button_pressed) {
 
 // --- Private Methods ---
 
-// Helper to get pixel status (block/no block)
-bool FillGame::get_pixel_status(int r, int c) {
-    if (r < 0 || r >= SCREEN_HEIGHT || c < 0 || c >= SCREEN_WIDTH) return false;
-    int byte_idx = GET_BYTE_INDEX(c);
-    int bit_pos = GET_BIT_POS(c);
-    return (m_playfield[r][byte_idx] >> bit_pos) & 1;
-}
-
-// Helper to set pixel status (block/no block)
-void FillGame::set_pixel_status(int r, int c, bool status) {
-    if (r < 0 || r >= SCREEN_HEIGHT || c < 0 || c >= SCREEN_WIDTH) return;
-    int byte_idx = GET_BYTE_INDEX(c);
-    int bit_pos = GET_BIT_POS(c);
-    if (status) {
-        m_playfield[r][byte_idx] |= (1 << bit_pos); // Set bit
-    } else {
-        m_playfield[r][byte_idx] &= ~(1 << bit_pos); // Clear bit
-    }
+void FillGame::shift_playfield_down() {
+    memmove(&m_playfield.rows[1], &m_playfield.rows[0], (SCREEN_HEIGHT - 1) * sizeof(m_playfield.rows[0]));
 }
 
 void FillGame::generate_new_top_row() {
-    for (int i = 0; i < SCREEN_WIDTH; i++) {
-        set_pixel_status(0, i, true); // Assume block by default
-    }
+    m_playfield.rows[0] = COLLISION_ROW_FULL; // Assume block by default
     for (int k = 0; k < m_num_gaps_per_row; ++k) {
-        int gap_x = rand() % SCREEN_WIDTH;
-        set_pixel_status(0, gap_x, false); // Make 'm_num_gaps_per_row' gaps
+        int gap_x = game_rand() % SCREEN_WIDTH;
+        m_playfield.reset(gap_x, 0); // Make 'm_num_gaps_per_row' gaps
     }
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 #define GAME_FILL_H
 
 #include "game_logic.h"
+#include "entity_pool.h"
+#include "collision_mask.h"
 
 // --- Internal Phase for the Fill Game ---
 enum FillGamePhase {
@@ -10,13 +12,7 @@ enum FillGamePhase {
     FILL_PHASE_GAMEOVER
 };
 
-#define MAX_PROJECTILES 5
-
-struct Projectile {
-    bool active;
-    int x;
-    int y;
-};
+const int MAX_PROJECTILES = 5;
 
 // --- Fill Game Class ---
 class FillGame : public IGame {
@@ -25,7 +21,10 @@ public:
     ~FillGame() = default;
 
     bool update(GameState& state, bool button_pressed) override;
-    void draw_title(GameState& state) override;
+    IGame* clone_into(void* storage) const override;
+
+    static const GameTitle TITLE;
+    GameplayPhase gameplay_phase() const override;
 
 private:
     // Game-specific state
@@ -35,8 +34,8 @@ private:
     int m_playfield_shift_timer;
     int m_line_clear_timer;
     int m_line_clear_y;
-    Projectile m_projectiles[MAX_PROJECTILES];
-    uint8_t m_playfield[SCREEN_HEIGHT][SCREEN_WIDTH / 8]; // Bit-packed: 1 bit per pixel
+    EntityPool<MAX_PROJECTILES> m_projectiles;
+    CollisionMask m_playfield; // Settled blocks, one bit per cell
     int m_frame_counter;
     int m_current_playfield_shift_speed;
     int m_current_player_move_speed;
@@ -44,10 +43,8 @@ private:
     int m_next_difficulty_score_threshold;
     int m_difficulty_level;
 
-    // Private helper methods for bit-packed playfield access
-    bool get_pixel_status(int r, int c);
-    void set_pixel_status(int r, int c, bool status);
-
+    // Private helper methods
+    void shift_playfield_down();
     void generate_new_top_row();
 };
 
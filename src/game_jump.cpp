@@ -1,17 +1,8 @@
 #include "game_jump.h"
 #include <string.h>
-#include <stdio.h>
 #include <stdlib.h>
-
-#ifdef __EMSCRIPTEN__
-#include <emscripten.h>
-// Webassembly-specific functions for jump game
-EM_JS(void, js_update_score, (int score), {
-    if (window.updateScoreDisplay) {
-        window.updateScoreDisplay(score);
-    }
-});
-#endif
+#include <new> // For placement new
+#include "trace.h"
 
 // --- Game Constants ---
 const float GRAVITY = 0.15f;
@@ -28,6 +19,7 @@ const int MAX_OBSTACLE_SPACING_LEVELS[] = {20, 16, 14, 10};
 const int OBSTACLE_HEIGHT_MAX_LEVELS[] = {3, 5, 5, 5}; // Max height of random walls
 const int SCORE_THRESHOLDS_JUMP[] = {5, 20, 50}; // Score needed to reach Level 1, 2, 3
 
+const GameTitle JumpGame::TITLE = {"JUMP", nullptr, 5, 0, PLAYER_COLOR, glyph_string_length("JUMP") * GLYPH_ADVANCE};
 
 // --- Constructor ---
 JumpGame::JumpGame(GameState& state) {
@@ -50,24 +42,25 @@ JumpGame::JumpGame(GameState& state) {
     m_current_obstacle_height_max = OBSTACLE_HEIGHT_MAX_LEVELS[0];
     m_next_difficulty_score_threshold = SCORE_THRESHOLDS_JUMP[0];
 
-    for (int i = 0; i < MAX_OBSTACLES; ++i) {
+    for (int i = 0; i < JUMP_MAX_OBSTACLES; ++i) {
         spawn_obstacle(m_obstacles[i], SCREEN_WIDTH + i * (m_current_min_obstacle_spacing + 2)); // Use current spacing
     }
-#ifdef __EMSCRIPTEN__
-    js_update_score(state.score);
-#endif
 }
 
 
 // --- Public Methods ---
 
-void JumpGame::draw_title(GameState& state) {
-    const char* title_text = "JUMP";
-    state.text_scroll_offset -= 0.5f;
-    if (state.text_scroll_offset < -(float)strlen(title_text) * 6) {
-        state.text_scroll_offset = SCREEN_WIDTH;
+IGame* JumpGame::clone_into(void* storage) const {
+    return new (storage) JumpGame(*this);
+}
+
+GameplayPhase JumpGame::gameplay_phase() const {
+    switch (m_phase) {
+        case JUMP_PHASE_COUNTDOWN: return GAMEPLAY_COUNTDOWN;
+        case JUMP_PHASE_PLAYING: return GAMEPLAY_PLAYING;
+        case JUMP_PHASE_GAMEOVER: break;
     }
-    draw_text(state, title_text, (int)state.text_scroll_offset, 5, 3);
+    return GAMEPLAY_GAMEOVER;
 }
 
 bool JumpGame::update(GameState& state, bool button_pressed) {
@@ -95,6 +88,7 @@ bool JumpGame::update(GameState& state, bool button_pressed) {
             // --- Difficulty Scaling ---
             if (m_difficulty_level < MAX_DIFFICULTY_LEVELS - 1 && state.score >= m_next_difficulty_score_threshold) {
                 m_difficulty_level++;
+                TRACE_EVENT(TRACE_LEVEL, m_difficulty_level);
                 m_current_obstacle_speed = OBSTACLE_SPEED_LEVELS[m_difficulty_level];
                 m_current_min_obstacle_spacing = MIN_OBSTACLE_SPACING_LEVELS[m_difficulty_level];
                 m_current_max_obstacle_spacing = MAX_OBSTACLE_SPACING_LEVELS[m_difficulty_level];
@@ -115,25 +109,22 @@ bool JumpGame::update(GameState& state, bool button_pressed) {
             
             update_obstacles();
 
-            for (int i = 0; i < MAX_OBSTACLES; ++i) {
+            for (int i = 0; i < JUMP_MAX_OBSTACLES; ++i) {
                 if (!m_obstacles[i].scored && (m_obstacles[i].x + OBSTACLE_WIDTH < m_player_x)) {
                     state.score++;
                     m_obstacles[i].scored = true;
-#ifdef __EMSCRIPTEN__
-                    js_update_score(state.score);
-#endif
                 }
             }
             
-            if (check_collision()) {
+            CollisionMask solid; // Walls, used for both the hit test and drawing
+            rasterize_obstacles(solid);
+            if (check_collision(solid)) {
+                TRACE_EVENT(TRACE_COLLISION, -1);
                 m_phase = JUMP_PHASE_GAMEOVER;
                 m_frame_counter = 0;
                 state.text_scroll_offset = SCREEN_WIDTH; // Reset for game over text
-#ifdef __EMSCRIPTEN__
-                js_update_score(state.score);
-#endif
             } else {
-                draw_obstacles(state);
+                solid.draw(state, OBSTACLE_COLOR);
                 draw_player(state);
             }
             break;
@@ -172,52 +163,38 @@ void JumpGame::draw_player(GameState& state) {
     }
 }
 
-void JumpGame::draw_obstacles(GameState& state) {
-    for (int i = 0; i < MAX_OBSTACLES; ++i) {
-        int obs_x = (int)m_obstacles[i].x;
-        for (int w = 0; w < OBSTACLE_WIDTH; ++w) {
-            if (obs_x + w < 0 || obs_x + w >= SCREEN_WIDTH) continue;
-            // Draw wall from floor up to obstacle.height
-            for (int y = 0; y < SCREEN_HEIGHT; ++y) {
-                if (y >= SCREEN_HEIGHT - m_obstacles[i].height) { // If y is within the wall's height from floor
-                    state.screen[y][obs_x + w] = OBSTACLE_COLOR;
-                }
-            }
-        }
+// Each wall is OBSTACLE_WIDTH wide and stands on the floor
+void JumpGame::rasterize_obstacles(CollisionMask& solid) const {
+    solid.clear();
+    for (int i = 0; i < JUMP_MAX_OBSTACLES; ++i) {
+        int height = m_obstacles[i].height;
+        solid.fill_rect((int)m_obstacles[i].x, SCREEN_HEIGHT - height, OBSTACLE_WIDTH, height);
     }
 }
 
 void JumpGame::spawn_obstacle(Obstacle& obstacle, float x_pos) {
     obstacle.x = x_pos;
-    obstacle.height = 1 + (rand() % m_current_obstacle_height_max); // Random height from 1 to m_current_obstacle_height_max
+    obstacle.height = 1 + (game_rand() % m_current_obstacle_height_max); // Random height from 1 to m_current_obstacle_height_max
     obstacle.scored = false;
+    TRACE_EVENT(TRACE_SPAWN, x_pos);
 }
 
 void JumpGame::update_obstacles() {
-    for (int i = 0; i < MAX_OBSTACLES; ++i) {
+    for (int i = 0; i < JUMP_MAX_OBSTACLES; ++i) {
         m_obstacles[i].x -= m_current_obstacle_speed; // Use current speed
         if (m_obstacles[i].x + OBSTACLE_WIDTH < 0) {
             float max_x = 0;
-            for (int j = 0; j < MAX_OBSTACLES; ++j) {
+            for (int j = 0; j < JUMP_MAX_OBSTACLES; ++j) {
                 if (m_obstacles[j].x > max_x) max_x = m_obstacles[j].x;
             }
-            int random_spacing = m_current_min_obstacle_spacing + (rand() % (m_current_max_obstacle_spacing - m_current_min_obstacle_spacing + 1)); // Use current spacing
+            int random_spacing = m_current_min_obstacle_spacing + (game_rand() % (m_current_max_obstacle_spacing - m_current_min_obstacle_spacing + 1)); // Use current spacing
             spawn_obstacle(m_obstacles[i], max_x + random_spacing);
         }
     }
 }
 
-bool JumpGame::check_collision() {
+bool JumpGame::check_collision(const CollisionMask& solid) const {
     int player_y_int = (int)m_player_y;
     if (player_y_int >= SCREEN_HEIGHT || player_y_int < 0) return true; // Boundary collision
-    for (int i = 0; i < MAX_OBSTACLES; ++i) {
-        int obs_x_start = (int)m_obstacles[i].x;
-        int obs_x_end = obs_x_start + OBSTACLE_WIDTH - 1;
-        if (m_player_x >= obs_x_start && m_player_x <= obs_x_end) { // Player is horizontally within obstacle
-            if (player_y_int >= (SCREEN_HEIGHT - m_obstacles[i].height)) { // Player is vertically within wall
-                return true; // Collision!
-            }
-        }
-    }
-    return false;
+    return solid.test(m_player_x, player_y_int);
 }
@@ -2,6 +2,7 @@
 #define GAME_JUMP_H
 
 #include "game_logic.h"
+#include "collision_mask.h"
 
 // --- Internal Phase for the Jump Game ---
 enum JumpGamePhase {
@@ -11,15 +12,12 @@ enum JumpGamePhase {
 };
 
 // --- Data Structures ---
-#ifndef OBSTACLE_DEFINED
-#define OBSTACLE_DEFINED
-#define MAX_OBSTACLES 2
+const int JUMP_MAX_OBSTACLES = 2;
 struct Obstacle {
     float x;          // horizontal position
     int height;       // height of the wall from the floor
     bool scored;
 };
-#endif
 
 // --- Jump Game Class ---
 class JumpGame : public IGame {
@@ -28,7 +26,10 @@ public:
     ~JumpGame() = default;
 
     bool update(GameState& state, bool button_pressed) override;
-    void draw_title(GameState& state) override;
+    IGame* clone_into(void* storage) const override;
+
+    static const GameTitle TITLE;
+    GameplayPhase gameplay_phase() const override;
 
 private:
     // Game-specific state
@@ -36,7 +37,7 @@ private:
     int m_player_x;
     float m_player_y;
     float m_player_velocity_y;
-    Obstacle m_obstacles[MAX_OBSTACLES];
+    Obstacle m_obstacles[JUMP_MAX_OBSTACLES];
     int m_frame_counter; // Internal frame counter
     float m_current_obstacle_speed;
     int m_current_min_obstacle_spacing;
@@ -47,9 +48,9 @@ private:
 
     // Private helper methods
     void draw_player(GameState& state);
-    void draw_obstacles(GameState& state);
+    void rasterize_obstacles(CollisionMask& solid) const;
     void update_obstacles();
-    bool check_collision();
+    bool check_collision(const CollisionMask& solid) const;
     void spawn_obstacle(Obstacle& obstacle, float x_pos);
 };
 
@@ -1,19 +1,37 @@
 #include "game_logic.h"
 #include "font.h" // Include the new font definition file
+#include "glyph_format.h"
+#include "framebuffer_kernels.h"
 #include <string.h>
-#include <stdio.h> // For sprintf
-#include <stdlib.h> // For rand()
+#include <stdlib.h>
 
 // Include the new class-based game headers
 #include "game_jump.h"
 #include "game_chase.h"
 #include "game_fill.h"
 #include "game_brightness.h"
+#include "game_bot.h"
+#include "persist.h"
+#include "mem_stats.h"
+#include "trace.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
+// --- Game Instance Allocation ---
+void* IGame::operator new(size_t size) noexcept {
+    void* ptr = malloc(size);
+    mem_stats_note_alloc(size, ptr != nullptr);
+    return ptr;
+}
+
+void IGame::operator delete(void* ptr, size_t size) {
+    if (!ptr) return;
+    mem_stats_note_free(size);
+    free(ptr);
+}
+
 // --- Factory Function ---
 // This is the only place with a switch statement for game types.
 IGame* create_game_instance(GameSelection selection, GameState& state) {
@@ -26,18 +44,47 @@ IGame* create_game_instance(GameSelection selection, GameState& state) {
     return nullptr; // Should not happen
 }
 
+// --- Title Screens ---
+// Indexed by GameSelection. Titles are plain data, so the menu can show any
+// game without constructing it.
+static const GameTitle* const GAME_TITLES[NUM_GAMES] = {
+    &JumpGame::TITLE,
+    &ChaseGame::TITLE,
+    &FillGame::TITLE,
+    &BrightnessGame::TITLE,
+};
+
+const GameTitle& game_title(GameSelection selection) {
+    return *GAME_TITLES[selection];
+}
+
+void draw_game_title(GameState& state, GameSelection selection) {
+    const GameTitle& title = game_title(selection);
+    state.text_scroll_offset -= 0.5f;
+    if (state.text_scroll_offset < -(float)title.scroll_width) {
+        state.text_scroll_offset = SCREEN_WIDTH;
+    }
+    draw_text(state, title.line1, (int)state.text_scroll_offset, title.line1_y, title.color);
+    if (title.line2) {
+        draw_text(state, title.line2, (int)state.text_scroll_offset, title.line2_y, title.color);
+    }
+}
+
 
 // --- WebAssembly-specific functions ---
 #ifdef __EMSCRIPTEN__
 EM_JS(void, js_draw_pixel, (int x, int y, int color), {
-    if (window.setPixelInGrid) {
+    if (typeof window !== "undefined" && window.setPixelInGrid) { // window is missing under Node
         window.setPixelInGrid(x, y, color);
     }
 });
 void render_screen(GameState& state) {
+    static uint8_t s_shown[SCREEN_HEIGHT * SCREEN_WIDTH]; // The page starts with every pixel at color 0
+    uint16_t masks[SCREEN_HEIGHT];
+    if (screen_diff(&state, s_shown, masks) == 0) return;
     for (int r = 0; r < SCREEN_HEIGHT; ++r) {
-        for (int c = 0; c < SCREEN_WIDTH; ++c) {
-            js_draw_pixel(c, r, state.screen[r][c]);
+        for (int c = 0; masks[r] >> c; ++c) {
+            if ((masks[r] >> c) & 1) js_draw_pixel(c, r, state.screen[r][c]);
         }
     }
 }
@@ -46,77 +93,166 @@ void render_screen(GameState& state) {
 // --- Game Constants ---
 const int BACKGROUND_COLOR = 0;
 
+// --- Random Numbers ---
+// xorshift32 instead of rand(), so a seed replays identically on AVR, WASM and
+// native builds (the C library generators all differ, and AVR's is never seeded).
+static uint32_t s_rng_state = 2463534242u;
+
+void game_srand(uint32_t seed) {
+    s_rng_state = seed ? seed : 2463534242u; // xorshift must not start at zero
+}
+
+int game_rand() {
+    uint32_t x = s_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng_state = x;
+    return (int)((x >> 16) & 0x7FFF);
+}
+
+uint32_t game_rand_state() {
+    return s_rng_state;
+}
+
+// --- Framebuffer Hash ---
+// Word-wise multiply-xor over the 256-byte screen, 8 bytes at a time.
+uint64_t hash_screen(const GameState& state) {
+    const uint8_t* bytes = &state.screen[0][0];
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (unsigned i = 0; i < sizeof(state.screen); i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+int screen_diff(const GameState* state, uint8_t* shown, uint16_t* masks) {
+    int changed = 0;
+    for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+        uint8_t* row = shown + r * SCREEN_WIDTH;
+        masks[r] = fb_diff_row(state->screen[r], row);
+        if (masks[r]) {
+            memcpy(row, state->screen[r], SCREEN_WIDTH);
+            changed++;
+        }
+    }
+    return changed;
+}
+
 // --- Core Drawing & Text Functions ---
-void clear_screen(GameState& state) { memset(state.screen, BACKGROUND_COLOR, sizeof(state.screen)); }
-void draw_char(GameState& state, char c, int x, int y, int color) {
-    int char_index = -1;
-    if (c >= '0' && c <= '9') char_index = c - '0';
-    else if (c >= 'A' && c <= 'Z') char_index = c - 'A' + 10;
-    else if (c >= 'a' && c <= 'z') char_index = c - 'a' + 10;
-    if (char_index != -1) {
-        for (int r = 0; r < 5; ++r) {
-            for (int col = 0; col < 5; ++col) {
-                if ((font_5x5[char_index][r] >> (4 - col)) & 1) {
-                    int px = x + col; int py = y + r;
-                    if (px < SCREEN_WIDTH && py < SCREEN_HEIGHT && px >= 0 && py >= 0)
-                        state.screen[py][px] = color;
-                }
+void clear_screen(GameState& state) { fb_fill_rows(&state.screen[0][0], SCREEN_HEIGHT, BACKGROUND_COLOR); }
+static void draw_glyph(GameState& state, uint8_t glyph, int x, int y, int color) {
+    if (glyph == GLYPH_BLANK) return;
+    for (int r = 0; r < 5; ++r) {
+        for (int col = 0; col < 5; ++col) {
+            if ((font_5x5[glyph][r] >> (4 - col)) & 1) {
+                int px = x + col; int py = y + r;
+                if (px < SCREEN_WIDTH && py < SCREEN_HEIGHT && px >= 0 && py >= 0)
+                    state.screen[py][px] = color;
             }
         }
     }
 }
+void draw_char(GameState& state, char c, int x, int y, int color) {
+    draw_glyph(state, glyph_for_char(c), x, y, color);
+}
 void draw_text(GameState& state, const char* text, int start_x, int start_y, int color) {
     int x = start_x;
-    while (*text) { draw_char(state, *text, x, start_y, color); x += 6; text++; }
+    while (*text) { draw_char(state, *text, x, start_y, color); x += GLYPH_ADVANCE; text++; }
+}
+void draw_glyphs(GameState& state, const uint8_t* glyphs, int count, int x, int y, int color, GlyphAlign align) {
+    x = glyph_align_x(x, count, align);
+    for (int i = 0; i < count; ++i) {
+        draw_glyph(state, glyphs[i], x, y, color);
+        x += GLYPH_ADVANCE;
+    }
 }
 void draw_score(GameState& state, int x, int y, int color) {
-    char score_str[4];
-    sprintf(score_str, "%d", state.score);
-    int text_width = strlen(score_str) * 6 - 1;
-    draw_text(state, score_str, x - text_width / 2, y, color);
+    uint8_t glyphs[GLYPH_UINT_MAX_DIGITS];
+    int count = format_uint_glyphs(glyphs, state.score > 0 ? (unsigned)state.score : 0);
+    draw_glyphs(state, glyphs, count, x, y, color, GLYPH_ALIGN_CENTER); // Centred on x
 }
 
 
 // --- Public API Functions ---
 
-// Resets state for returning to the title screen, recreating the game instance
+// Resets state for returning to the title screen. The game instance is freed;
+// the next one is only created when a game actually starts.
 void init_game(GameState& state) {
     state.phase = PHASE_TITLE;
     state.button_down_frames = 0;
     state.text_scroll_offset = SCREEN_WIDTH; // Explicitly reset scroll for title screen
     state.game_switched_on_long_press = false;
     state.ignore_input_until_release = true;
+    state.idle_frames = 0;
+    state.demo_mode = false;
+    state.score = 0;
 
-    // --- FIX: Re-create the game instance ---
-    if (state.game_instance) { // Only delete if one exists
-        delete state.game_instance;
-    }
+    delete state.game_instance;
+    state.game_instance = nullptr;
+}
+
+// Creates the selected game and leaves the title screen. Returns false (and
+// stays on the title) if there is no memory for the game.
+static bool start_selected_game(GameState& state) {
+    delete state.game_instance; // Normally already freed by init_game
     state.game_instance = create_game_instance(state.current_selection, state);
+    if (!state.game_instance) return false;
+    state.phase = (GamePhase)1; // Any phase other than TITLE
+    TRACE_EVENT(TRACE_GAME_START, state.current_selection);
+    TRACE_EVENT(TRACE_PHASE, state.game_instance->gameplay_phase());
+    return true;
+}
+
+// Queues high scores and brightness for saving; persist_save ignores unchanged data
+static void save_progress(GameState& state) {
+    if (state.current_selection != GAME_BRIGHTNESS_ADJUSTMENT &&
+        state.score > state.high_scores[state.current_selection]) {
+        state.high_scores[state.current_selection] = state.score;
+    }
+    PersistentData data;
+    memcpy(data.high_scores, state.high_scores, sizeof(data.high_scores));
+    data.brightness = state.current_brightness;
+    persist_save(data);
 }
 
-// Sets up the very first game instance on startup
+// Sets up the title screen on startup
 void set_initial_game(GameState& state) {
     state.current_selection = GAME_JUMP;
-    state.current_brightness = 16; // Initialize brightness once at startup
-    state.game_instance = create_game_instance(state.current_selection, state);
-    if (!state.game_instance) {
-        // Fallback if allocation fails (e.g., out of memory on Arduino)
-        state.current_selection = GAME_JUMP; // Ensure selection is fallback game
-        state.game_instance = new JumpGame(state); // Try allocating JumpGame as fallback
-        if (!state.game_instance) {
-             // If even JumpGame fails, something is seriously wrong, possibly a global crash or a very small heap.
-             // For now, let's just assert or loop. On Arduino, a reset might be better.
-             while(true); // Hard lock if critical failure
-        }
-    }
+
+    // Brightness and high scores come from persistent storage (defaults on first boot)
+    PersistentData data;
+    persist_load(data);
+    state.current_brightness = data.brightness;
+    memcpy(state.high_scores, data.high_scores, sizeof(state.high_scores));
+
+    state.game_instance = nullptr; // Created when a game starts
     init_game(state); // Set initial phase to title
 }
 
 
-void update_game(GameState& state, bool button_pressed) {
-    clear_screen(state);
+// Advances the state by one frame. Returns false when the frame was swallowed
+// while waiting for the button to be released; nothing is drawn then, and
+// state.screen keeps the last drawn frame.
+static bool step_game(GameState& state, bool button_pressed) {
+    persist_tick(); // Background EEPROM writes, one byte per frame
 
     const int LONG_PRESS_FRAMES = 20;
+    const int ATTRACT_DELAY_FRAMES = 600; // ~10 seconds of idle title before the demo starts
+
+#if ATTRACT_MODE
+    // --- Attract mode: the bot holds the button, any real input ends the demo ---
+    if (state.demo_mode) {
+        if (button_pressed) {
+            init_game(state);
+        } else {
+            button_pressed = bot_choose_input(state, BOT_DEFAULT_SEARCH_BUDGET);
+        }
+    }
+#endif
 
     if (state.ignore_input_until_release) {
         // Block all input processing until button is released
@@ -126,9 +262,11 @@ void update_game(GameState& state, bool button_pressed) {
             state.button_down_frames = 0;
             state.game_switched_on_long_press = false;
         }
-        return; // Exit update_game early if ignoring input
+        return false; // Exit early if ignoring input; the screen keeps the last drawn frame
     }
 
+    clear_screen(state);
+
     // --- Normal input processing ---
     if (button_pressed) {
         state.button_down_frames++;
@@ -138,13 +276,7 @@ void update_game(GameState& state, bool button_pressed) {
             // Long press: switch game on title
             if (state.phase == PHASE_TITLE) {
                 state.current_selection = (GameSelection)((state.current_selection + 1) % NUM_GAMES);
-                delete state.game_instance;
-                state.game_instance = create_game_instance(state.current_selection, state);
-                if (!state.game_instance) {
-                    state.current_selection = GAME_JUMP; // Fallback to JumpGame
-                    state.game_instance = new JumpGame(state);
-                    if (!state.game_instance) { while(true); } // Critical failure
-                }
+                TRACE_EVENT(TRACE_GAME_SWITCH, state.current_selection);
             }
             state.game_switched_on_long_press = true; // Mark action as taken for this hold
         }
@@ -152,8 +284,8 @@ void update_game(GameState& state, bool button_pressed) {
         // Short press logic - only if no long press action was taken during this hold
         if (state.button_down_frames > 0 && !state.game_switched_on_long_press) {
             if (state.phase == PHASE_TITLE) {
-                // Short press: start game
-                state.phase = (GamePhase)1; // Any phase other than TITLE
+                // Short press: start game (stays on the title if it cannot be allocated)
+                start_selected_game(state);
             }
         }
         // Reset all button related state on release
@@ -163,21 +295,98 @@ void update_game(GameState& state, bool button_pressed) {
 
     // --- Drawing for Title phase ---
     if (state.phase == PHASE_TITLE) {
-        if (state.game_instance) {
-            state.game_instance->draw_title(state);
+        draw_game_title(state, state.current_selection);
+
+        state.idle_frames = button_pressed ? 0 : state.idle_frames + 1;
+        if (ATTRACT_MODE && state.idle_frames >= ATTRACT_DELAY_FRAMES &&
+            state.current_selection != GAME_BRIGHTNESS_ADJUSTMENT &&
+            start_selected_game(state)) {
+            state.demo_mode = true;
         }
     } else { // Game is in progress
         if (state.game_instance) {
+#ifdef POCHI_TRACE
+            GameplayPhase phase_before = state.game_instance->gameplay_phase();
+#endif
             bool wants_to_return_to_title = state.game_instance->update(state, button_pressed);
+#ifdef POCHI_TRACE
+            GameplayPhase phase_after = state.game_instance->gameplay_phase();
+            if (phase_after != phase_before) TRACE_EVENT(TRACE_PHASE, phase_after);
+#endif
+            if (!state.demo_mode && (wants_to_return_to_title || state.game_instance->is_game_over())) {
+                save_progress(state);
+            }
             if (wants_to_return_to_title) {
+                TRACE_EVENT(TRACE_GAME_EXIT, state.score);
                 init_game(state); // Reset state for returning to title screen
             }
         }
     }
 
     state.was_button_pressed_last_frame = button_pressed;
+    return true;
+}
 
+void update_game(GameState& state, bool button_pressed) {
+    TRACE_EVENT(TRACE_FRAME_BEGIN, state.current_selection);
+    bool drawn = step_game(state, button_pressed);
+    TRACE_EVENT(TRACE_FRAME_END, drawn);
+    if (!drawn) return;
 #ifdef __EMSCRIPTEN__
     render_screen(state);
 #endif
-}
\ No newline at end of file
+}
+
+// Runs n frames in one call. inputs holds one button bit per frame, LSB first
+// (frame i is bit i % 8 of inputs[i / 8]). Only the last drawn frame is
+// rendered unless UPDATE_N_RENDER_EVERY_FRAME or UPDATE_N_NO_RENDER is set.
+// Returns the number of frames that were drawn into state.screen.
+int update_game_n(GameState& state, const uint8_t* inputs, int n, int flags) {
+    int drawn = 0;
+    for (int i = 0; i < n; ++i) {
+        bool button_pressed = (inputs[i >> 3] >> (i & 7)) & 1;
+        TRACE_EVENT(TRACE_FRAME_BEGIN, state.current_selection);
+        bool frame_drawn = step_game(state, button_pressed);
+        TRACE_EVENT(TRACE_FRAME_END, frame_drawn);
+        if (frame_drawn) {
+            drawn++;
+#ifdef __EMSCRIPTEN__
+            if ((flags & UPDATE_N_RENDER_EVERY_FRAME) && !(flags & UPDATE_N_NO_RENDER)) render_screen(state);
+#endif
+        }
+    }
+#ifdef __EMSCRIPTEN__
+    if (drawn > 0 && !(flags & (UPDATE_N_RENDER_EVERY_FRAME | UPDATE_N_NO_RENDER))) render_screen(state);
+#else
+    (void)flags;
+#endif
+    return drawn;
+}
+
+// --- State Handles ---
+GameState* create_game_state() {
+    GameState* state = new GameState(); // Value-initialised: no garbage game_instance
+    if (state) set_initial_game(*state);
+    return state;
+}
+
+void destroy_game_state(GameState* state) {
+    if (!state) return;
+    delete state->game_instance;
+    delete state;
+}
+
+// Filled in at compile time, so JS never has to guess the struct layout
+static const uint32_t GAME_STATE_LAYOUT[LAYOUT_NUM_FIELDS] = {
+    sizeof(GameState),
+    alignof(GameState),
+    offsetof(GameState, screen),
+    offsetof(GameState, score),
+    offsetof(GameState, current_brightness),
+    offsetof(GameState, phase),
+    offsetof(GameState, current_selection),
+};
+
+const uint32_t* game_state_layout() {
+    return GAME_STATE_LAYOUT;
+}
@@ -2,6 +2,8 @@
 #define GAME_LOGIC_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include "glyph_format.h"
 
 #define SCREEN_WIDTH 16
 #define SCREEN_HEIGHT 16
@@ -9,19 +11,51 @@
 // --- Forward declaration for GameState ---
 struct GameState;
 
+// --- Coarse phase of a running game, shared by all games (for tools and bots) ---
+enum GameplayPhase {
+    GAMEPLAY_COUNTDOWN,
+    GAMEPLAY_PLAYING,
+    GAMEPLAY_GAMEOVER
+};
+
 // --- Abstract Base Class for Games ---
 class IGame {
 public:
     virtual ~IGame() = default;
 
+    // Game instances allocate through these so mem_stats can track the heap.
+    // A failed allocation returns nullptr (callers fall back) instead of throwing.
+    static void* operator new(size_t size) noexcept;
+    static void operator delete(void* ptr, size_t size);
+    static void* operator new(size_t, void* place) noexcept { return place; } // Placement (clone_into)
+
     // Main update function for a game. Returns true if it wants to exit to title.
     virtual bool update(GameState& state, bool button_pressed) = 0;
 
-    // Draws the game-specific title screen.
-    virtual void draw_title(GameState& state) = 0;
+    // Copy-constructs this game into caller-provided storage (see GameInstanceStorage
+    // in game_bot.h). Used for cheap, allocation-free lookahead. Destroy with ~IGame().
+    virtual IGame* clone_into(void* storage) const = 0;
+
+    // Which of the common phases the game is in.
+    virtual GameplayPhase gameplay_phase() const = 0;
+
+    // True once the game has reached its game-over screen.
+    bool is_game_over() const { return gameplay_phase() == GAMEPLAY_GAMEOVER; }
 };
 
 
+// --- Title Screen Descriptor ---
+// Everything the title (and menu) needs, as constant data, so browsing the
+// menu never constructs a game. Each game defines one as its static TITLE.
+struct GameTitle {
+    const char* line1;
+    const char* line2;    // nullptr for a one-line title
+    int8_t line1_y;
+    int8_t line2_y;
+    uint8_t color;
+    int16_t scroll_width; // Pixels scrolled before the text wraps around
+};
+
 // --- Core Enums ---
 enum GamePhase {
     PHASE_TITLE,
@@ -55,6 +89,28 @@ struct GameState {
     int frame_count;
     float text_scroll_offset;
     uint8_t current_brightness;
+    uint16_t high_scores[NUM_GAMES]; // Loaded from and saved to persistent storage
+
+    // Attract mode: the bot plays a demo after the title has been idle for a while
+    int idle_frames;
+    bool demo_mode;
+};
+
+// --- Flags for update_game_n ---
+#define UPDATE_N_RENDER_EVERY_FRAME 0x01 // Render intermediate frames too (default: last frame only)
+#define UPDATE_N_NO_RENDER 0x02 // Never render; the caller reads state.screen itself
+
+// --- GameState layout for hosts that read the struct directly (JS) ---
+// game_state_layout() returns one uint32_t per entry, indexed by this enum.
+enum GameStateLayoutField {
+    LAYOUT_SIZE,
+    LAYOUT_ALIGN,
+    LAYOUT_SCREEN,
+    LAYOUT_SCORE,
+    LAYOUT_BRIGHTNESS,
+    LAYOUT_PHASE,
+    LAYOUT_SELECTION,
+    LAYOUT_NUM_FIELDS
 };
 
 #ifdef __cplusplus
@@ -65,16 +121,45 @@ extern "C" {
 void init_game(GameState& state);
 void set_initial_game(GameState& state);
 void update_game(GameState& state, bool jump_button_pressed);
+int update_game_n(GameState& state, const uint8_t* inputs, int n, int flags);
+
+// --- State handles (each owns its game instance) ---
+GameState* create_game_state(); // Zeroed and passed through set_initial_game()
+void destroy_game_state(GameState* state);
+const uint32_t* game_state_layout();
+
+// --- Deterministic random numbers (same sequence on every platform) ---
+void game_srand(uint32_t seed);
+int game_rand(); // 0..32767
+uint32_t game_rand_state(); // Passing this back to game_srand() resumes the sequence
+
+// --- Framebuffer hash for regression checks ---
+uint64_t hash_screen(const GameState& state);
+
+// --- Changed pixels, for hosts that redraw incrementally (JS) ---
+// Compares state.screen against `shown` (SCREEN_WIDTH * SCREEN_HEIGHT bytes,
+// what the host last drew), writes one bitmask of changed pixels per row to
+// `masks`, copies the changed rows into `shown` and returns how many rows changed.
+int screen_diff(const GameState* state, uint8_t* shown, uint16_t* masks);
 
 // --- Drawing helpers (to be used by multiple games) ---
 void clear_screen(GameState& state);
 void draw_char(GameState& state, char c, int x, int y, int color);
 void draw_text(GameState& state, const char* text, int start_x, int start_y, int color);
-void draw_score(GameState& state, int x, int y, int color);
+void draw_glyphs(GameState& state, const uint8_t* glyphs, int count, int x, int y, int color, GlyphAlign align);
+void draw_score(GameState& state, int x, int y, int color); // Centred on x
+#ifdef __EMSCRIPTEN__
+void render_screen(GameState& state);
+#endif
 
 
 #ifdef __cplusplus
 }
+
+// --- Game factory and titles (in game_logic.cpp) ---
+IGame* create_game_instance(GameSelection selection, GameState& state);
+const GameTitle& game_title(GameSelection selection);
+void draw_game_title(GameState& state, GameSelection selection); // Scrolls state.text_scroll_offset
 #endif
 
 #endif // GAME_LOGIC_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef GLYPH_FORMAT_H
+#define GLYPH_FORMAT_H
+
+#include <stdint.h>
+#include <limits.h>
+
+// --- Glyph formatting ---
+// Turns characters and integers straight into font_5x5 indices for
+// draw_glyphs(), without stdio or allocation. The constexpr helpers let
+// callers size buffers and lay out text at compile time.
+
+const uint8_t GLYPH_BLANK = 0xFF; // Advances the cursor without drawing
+const int GLYPH_ADVANCE = 6;      // 5 pixel glyph + 1 pixel gap
+
+enum GlyphAlign {
+    GLYPH_ALIGN_LEFT,   // x is the left edge
+    GLYPH_ALIGN_CENTER, // x is the centre pixel
+    GLYPH_ALIGN_RIGHT   // x is the right edge
+};
+
+// Font index for '0'-'9', 'A'-'Z' and 'a'-'z'; everything else is blank
+constexpr uint8_t glyph_for_char(char c) {
+    return (c >= '0' && c <= '9') ? (uint8_t)(c - '0')
+         : (c >= 'A' && c <= 'Z') ? (uint8_t)(c - 'A' + 10)
+         : (c >= 'a' && c <= 'z') ? (uint8_t)(c - 'a' + 10)
+         : GLYPH_BLANK;
+}
+
+constexpr int glyph_string_length(const char* text) {
+    return *text ? 1 + glyph_string_length(text + 1) : 0;
+}
+
+constexpr int glyph_digit_count(unsigned value) {
+    return value < 10 ? 1 : 1 + glyph_digit_count(value / 10);
+}
+
+// Width in pixels of count glyphs, without the trailing gap
+constexpr int glyph_text_width(int count) {
+    return count > 0 ? count * GLYPH_ADVANCE - 1 : 0;
+}
+
+// Left edge for drawing count glyphs at x with the given alignment
+constexpr int glyph_align_x(int x, int count, GlyphAlign align) {
+    return align == GLYPH_ALIGN_CENTER ? x - glyph_text_width(count) / 2
+         : align == GLYPH_ALIGN_RIGHT ? x - glyph_text_width(count) + 1
+         : x;
+}
+
+// Enough for any unsigned int (5 digits on AVR, 10 on 32-bit targets)
+const int GLYPH_UINT_MAX_DIGITS = glyph_digit_count(UINT_MAX);
+
+// Writes value as digit glyphs to out and returns the glyph count. The number
+// is right-aligned in at least width glyphs, padded on the left with pad
+// (GLYPH_BLANK, or glyph_for_char('0') for zero padding). out must hold
+// max(width, GLYPH_UINT_MAX_DIGITS) glyphs.
+inline int format_uint_glyphs(uint8_t* out, unsigned value, int width = 0, uint8_t pad = GLYPH_BLANK) {
+    int digits = glyph_digit_count(value);
+    int count = digits < width ? width : digits;
+    for (int i = count - 1; i >= count - digits; --i) {
+        out[i] = (uint8_t)(value % 10);
+        value /= 10;
+    }
+    for (int i = 0; i < count - digits; ++i) out[i] = pad;
+    return count;
+}
+
+#endif // GLYPH_FORMAT_H
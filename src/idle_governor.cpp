@@ -0,0 +1,53 @@
+#include "idle_governor.h"
+#include "game_brightness.h"
+
+// Screens that keep running without anyone playing
+static bool is_passive_screen(const GameState& state) {
+    if (state.phase == PHASE_TITLE || state.demo_mode) return true;
+    if (state.current_selection == GAME_BRIGHTNESS_ADJUSTMENT) return true;
+    return state.game_instance && state.game_instance->is_game_over();
+}
+
+void idle_governor_init(IdleGovernor& gov, uint32_t now_ms) {
+    gov.last_input_ms = now_ms;
+    gov.mode = POWER_ACTIVE;
+}
+
+PowerMode idle_governor_update(IdleGovernor& gov, GameState& state, bool button_pressed, uint32_t now_ms) {
+    if (button_pressed || !is_passive_screen(state)) {
+        if (gov.mode == POWER_SLEEP && button_pressed) {
+            state.ignore_input_until_release = true; // The wake-up press is not a game input
+        }
+        gov.last_input_ms = now_ms;
+        gov.mode = POWER_ACTIVE;
+        return POWER_ACTIVE;
+    }
+
+    uint32_t idle_ms = now_ms - gov.last_input_ms;
+    PowerMode mode = idle_ms >= IDLE_SLEEP_AFTER_MS ? POWER_SLEEP
+                   : idle_ms >= IDLE_DIM_AFTER_MS ? POWER_DIM
+                   : POWER_ACTIVE;
+
+    if (mode == POWER_SLEEP && gov.mode != POWER_SLEEP && state.phase != PHASE_TITLE) {
+        init_game(state); // Wake up on the title, not on a stale game-over screen
+    }
+    if (mode != POWER_ACTIVE) {
+        if (state.demo_mode) init_game(state); // No demo on a dimmed screen
+        state.idle_frames = 0; // Keeps attract mode from starting again
+    }
+    gov.mode = mode;
+    return mode;
+}
+
+uint16_t idle_governor_frame_interval_ms(const IdleGovernor& gov, uint16_t active_interval_ms) {
+    return gov.mode == POWER_ACTIVE ? active_interval_ms : IDLE_DIM_FRAME_INTERVAL_MS;
+}
+
+uint8_t idle_governor_brightness(const IdleGovernor& gov, uint8_t brightness) {
+    switch (gov.mode) {
+        case POWER_ACTIVE: return brightness;
+        case POWER_DIM: return BrightnessGame::dimmed_brightness(brightness, IDLE_DIM_BRIGHTNESS_STEPS);
+        case POWER_SLEEP: break;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef IDLE_GOVERNOR_H
+#define IDLE_GOVERNOR_H
+
+#include "game_logic.h"
+
+// --- Idle governor ---
+//
+// Tracks how long a passive screen (title, attract demo, game over, brightness
+// menu) has gone without input and picks a power mode for the frame loop:
+//   POWER_ACTIVE  normal frame rate and brightness
+//   POWER_DIM     after IDLE_DIM_AFTER_MS: IDLE_DIM_FRAME_INTERVAL_MS frames and
+//                 brightness IDLE_DIM_BRIGHTNESS_STEPS levels down the brightness LUT
+//   POWER_SLEEP   after IDLE_SLEEP_AFTER_MS: the board should blank the matrix, stop
+//                 calling update_game() and sleep until the button is pressed
+// The attract demo is ended on the way into POWER_DIM and does not restart until
+// the governor is active again. A running game never counts as idle. Time is in
+// milliseconds from the caller's clock (millis()), so the governor works at any
+// frame rate; differences are taken with wrap-around.
+
+enum PowerMode {
+    POWER_ACTIVE,
+    POWER_DIM,
+    POWER_SLEEP
+};
+
+#ifndef IDLE_DIM_AFTER_MS
+#define IDLE_DIM_AFTER_MS 30000UL    // 30 s
+#endif
+#ifndef IDLE_SLEEP_AFTER_MS
+#define IDLE_SLEEP_AFTER_MS 300000UL // 5 min
+#endif
+#define IDLE_DIM_FRAME_INTERVAL_MS 50 // 20 fps
+#define IDLE_DIM_BRIGHTNESS_STEPS 2
+
+struct IdleGovernor {
+    uint32_t last_input_ms; // Last press, or last frame of a running game
+    uint8_t mode;           // PowerMode
+};
+
+void idle_governor_init(IdleGovernor& gov, uint32_t now_ms);
+
+// Call once per frame before update_game(). Returns the mode for this frame.
+// A press in POWER_SLEEP wakes the governor and is swallowed (the game ignores
+// the button until it is released), so waking never starts a game.
+PowerMode idle_governor_update(IdleGovernor& gov, GameState& state, bool button_pressed, uint32_t now_ms);
+
+// Frame interval for the current mode, given the normal one
+uint16_t idle_governor_frame_interval_ms(const IdleGovernor& gov, uint16_t active_interval_ms);
+
+// Brightness to show for the current mode, given the user's setting
+uint8_t idle_governor_brightness(const IdleGovernor& gov, uint8_t brightness);
+
+#endif // IDLE_GOVERNOR_H
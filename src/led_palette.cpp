@@ -0,0 +1,17 @@
+#include "led_palette.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PALETTE_BYTE(p) pgm_read_byte(p)
+#else
+#define PALETTE_BYTE(p) (*(p))
+#endif
+
+void led_palette_build(LedPalette& lut, const uint8_t palette[][3], int colors, uint8_t brightness) {
+    for (int i = 0; i < LED_PALETTE_COLORS; ++i) {
+        for (int ch = 0; ch < 3; ++ch) {
+            uint16_t value = i < colors ? ((uint16_t)PALETTE_BYTE(&palette[i][ch]) * brightness + 127) / 255 : 0;
+            lut.tables[ch][i] = (uint8_t)value;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef LED_PALETTE_H
+#define LED_PALETTE_H
+
+#include "game_logic.h"
+
+// --- LED palette at the shown brightness ---
+//
+// led_palette_build() scales the game palette to a brightness once, when the
+// brightness changes, into one 16-entry table per channel. Drawing a row is
+// then three palette lookups (fb_palette_row), and the exact 8-bit values go
+// to the LEDs through the matrix's pass-through colour. The LEDs must be driven
+// at full brightness (setBrightness(255)), since the level is in the tables.
+
+#define LED_PALETTE_COLORS 16 // Palette indexes covered by the tables (fb_palette_row size)
+
+struct LedPalette {
+    uint8_t tables[3][LED_PALETTE_COLORS]; // [red, green, blue][palette index]
+};
+
+// Fills the tables for `colors` palette entries (RGB, 0..255; in PROGMEM on
+// AVR) scaled to `brightness`, rounded to the nearest LED step; entries past
+// `colors` are black.
+void led_palette_build(LedPalette& lut, const uint8_t palette[][3], int colors, uint8_t brightness);
+
+#endif // LED_PALETTE_H
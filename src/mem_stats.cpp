@@ -0,0 +1,80 @@
+#include "mem_stats.h"
+#include "game_bot.h" // Game classes and GameInstanceStorage
+
+#ifdef __AVR__
+#include <avr/io.h>
+extern uint8_t __heap_start;
+extern uint8_t* __brkval; // Current heap top, 0 until the first malloc
+#endif
+
+// --- Heap Accounting ---
+static uint32_t s_heap_current;
+static uint32_t s_heap_peak;
+static uint32_t s_heap_allocs;
+static uint32_t s_heap_failures;
+
+void mem_stats_note_alloc(size_t size, bool ok) {
+    if (!ok) {
+        s_heap_failures++;
+        return;
+    }
+    s_heap_allocs++;
+    s_heap_current += size;
+    if (s_heap_current > s_heap_peak) s_heap_peak = s_heap_current;
+}
+
+void mem_stats_note_free(size_t size) {
+    s_heap_current -= size;
+}
+
+// --- Stack Painting (AVR) ---
+#ifdef __AVR__
+const uint8_t STACK_PAINT = 0xC5;
+const int STACK_PAINT_MARGIN = 16; // Leave the caller's own frame alone
+
+static uint8_t* heap_top() {
+    return __brkval ? __brkval : &__heap_start;
+}
+
+void mem_stats_init() {
+    uint8_t* sp = (uint8_t*)SP;
+    for (uint8_t* p = heap_top(); p < sp - STACK_PAINT_MARGIN; ++p) *p = STACK_PAINT;
+}
+
+static uint32_t stack_high_water() {
+    uint8_t* p = heap_top();
+    while (p <= (uint8_t*)RAMEND && *p == STACK_PAINT) ++p; // First byte the stack ever touched
+    return (uint8_t*)RAMEND - p + 1;
+}
+
+static uint32_t free_ram() {
+    return (uint8_t*)SP - heap_top();
+}
+#else
+void mem_stats_init() {}
+static uint32_t stack_high_water() { return 0; }
+static uint32_t free_ram() { return 0; }
+#endif
+
+// --- Public API ---
+
+void mem_stats_get(MemStats* stats) {
+    stats->stack_high_water = stack_high_water();
+    stats->free_ram = free_ram();
+    stats->heap_current = s_heap_current;
+    stats->heap_peak = s_heap_peak;
+    stats->heap_allocs = s_heap_allocs;
+    stats->heap_failures = s_heap_failures;
+    stats->sizeof_game_state = sizeof(GameState);
+    stats->sizeof_jump_game = sizeof(JumpGame);
+    stats->sizeof_chase_game = sizeof(ChaseGame);
+    stats->sizeof_fill_game = sizeof(FillGame);
+    stats->sizeof_brightness_game = sizeof(BrightnessGame);
+    stats->sizeof_instance_storage = sizeof(GameInstanceStorage);
+}
+
+MemStats* mem_stats_snapshot() {
+    static MemStats stats;
+    mem_stats_get(&stats);
+    return &stats;
+}
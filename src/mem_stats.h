@@ -0,0 +1,44 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Memory telemetry ---
+// Heap figures count game instances, which allocate through IGame's operator
+// new/delete. Stack figures need stack painting and are only available on AVR
+// (0 elsewhere). All fields are uint32_t so JS can read the struct from HEAPU32.
+struct MemStats {
+    uint32_t stack_high_water;   // Deepest stack use since mem_stats_init(), in bytes
+    uint32_t free_ram;           // Unpainted gap between heap top and stack right now
+    uint32_t heap_current;       // Bytes held by live game instances
+    uint32_t heap_peak;
+    uint32_t heap_allocs;        // Number of game instance allocations so far
+    uint32_t heap_failures;      // Allocations that returned null
+    uint32_t sizeof_game_state;
+    uint32_t sizeof_jump_game;
+    uint32_t sizeof_chase_game;
+    uint32_t sizeof_fill_game;
+    uint32_t sizeof_brightness_game;
+    uint32_t sizeof_instance_storage; // GameInstanceStorage, used by the bot and tools
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Paints the free stack area (AVR). Call as early as possible, e.g. first in setup().
+void mem_stats_init();
+void mem_stats_get(MemStats* stats);
+// Fills and returns a static MemStats (for the WASM module)
+MemStats* mem_stats_snapshot();
+
+// Called by IGame's allocation operators
+void mem_stats_note_alloc(size_t size, bool ok);
+void mem_stats_note_free(size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_STATS_H
@@ -0,0 +1,220 @@
+#include "persist.h"
+#include "game_brightness.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#elif defined(ARDUINO)
+#include <EEPROM.h>
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+// --- Record Layout ---
+// magic, seq (u16), PersistentData fields, CRC-8 over everything before it
+const uint8_t RECORD_MAGIC = 0x50;
+const int PAYLOAD_SIZE = NUM_GAMES * 2 + 1;
+const int RECORD_SIZE = 1 + 2 + PAYLOAD_SIZE + 1;
+const int NUM_SLOTS = PERSIST_STORAGE_SIZE / RECORD_SIZE;
+const uint8_t DEFAULT_BRIGHTNESS = 16;
+
+// --- Storage Backends ---
+#if defined(__AVR__)
+static void backend_begin() {}
+static uint8_t backend_read(int addr) { return eeprom_read_byte((const uint8_t*)addr); }
+static bool backend_ready() { return eeprom_is_ready(); }
+static void backend_write(int addr, uint8_t value) { eeprom_write_byte((uint8_t*)addr, value); }
+static void backend_commit() {}
+
+#elif defined(ARDUINO)
+static void backend_begin() { EEPROM.begin(PERSIST_STORAGE_SIZE); }
+static uint8_t backend_read(int addr) { return EEPROM.read(addr); }
+static bool backend_ready() { return true; }
+static void backend_write(int addr, uint8_t value) { EEPROM.write(addr, value); }
+static void backend_commit() { EEPROM.commit(); } // Flash-emulated EEPROM needs an explicit commit
+
+#elif defined(__EMSCRIPTEN__)
+// The whole storage is kept as a hex string under one localStorage key
+EM_JS(void, js_storage_init, (int size), {
+    Module.persistCache = new Uint8Array(size).fill(0xff);
+    let hex = null;
+    try { hex = localStorage.getItem('pochi-pochi-eeprom'); } catch (e) {}
+    if (hex) {
+        for (let i = 0; i < size && i * 2 < hex.length; i++) {
+            Module.persistCache[i] = parseInt(hex.substr(i * 2, 2), 16);
+        }
+    }
+});
+EM_JS(int, js_storage_read, (int addr), {
+    return Module.persistCache[addr];
+});
+EM_JS(void, js_storage_write, (int addr, int value), {
+    Module.persistCache[addr] = value;
+});
+// The hex string is rebuilt once per record, not per byte
+EM_JS(void, js_storage_commit, (), {
+    let hex = '';
+    for (let i = 0; i < Module.persistCache.length; i++) {
+        hex += (Module.persistCache[i] < 16 ? '0' : '') + Module.persistCache[i].toString(16);
+    }
+    try { localStorage.setItem('pochi-pochi-eeprom', hex); } catch (e) {}
+});
+static void backend_begin() { js_storage_init(PERSIST_STORAGE_SIZE); }
+static uint8_t backend_read(int addr) { return (uint8_t)js_storage_read(addr); }
+static bool backend_ready() { return true; }
+static void backend_write(int addr, uint8_t value) { js_storage_write(addr, value); }
+static void backend_commit() { js_storage_commit(); }
+
+#else
+// Native: a file named by $POCHI_EEPROM, mirrored in memory
+static uint8_t s_file_storage[PERSIST_STORAGE_SIZE];
+static FILE* s_file;
+static bool s_file_opened; // The mirror holds the storage; later loads reuse it
+
+static void backend_begin() {
+    if (s_file_opened) return;
+    s_file_opened = true;
+    memset(s_file_storage, 0xFF, sizeof(s_file_storage)); // Erased EEPROM reads 0xFF
+    const char* path = getenv("POCHI_EEPROM");
+    if (!path) return;
+    s_file = fopen(path, "r+b");
+    if (!s_file) s_file = fopen(path, "w+b");
+    if (!s_file) return;
+    if (fread(s_file_storage, 1, sizeof(s_file_storage), s_file) < sizeof(s_file_storage)) {
+        memset(s_file_storage, 0xFF, sizeof(s_file_storage));
+        fseek(s_file, 0, SEEK_SET);
+        fwrite(s_file_storage, 1, sizeof(s_file_storage), s_file);
+    }
+}
+static uint8_t backend_read(int addr) { return s_file_storage[addr]; }
+static bool backend_ready() { return true; }
+static void backend_write(int addr, uint8_t value) {
+    s_file_storage[addr] = value;
+    if (s_file) {
+        fseek(s_file, addr, SEEK_SET);
+        fputc(value, s_file);
+    }
+}
+static void backend_commit() {
+    if (s_file) fflush(s_file);
+}
+#endif
+
+// --- Write Queue ---
+static PersistentData s_saved;          // Newest data (written or queued)
+static bool s_dirty;                    // s_saved changed while a record was being written
+static uint8_t s_record[RECORD_SIZE];   // Record being written
+static int s_record_pos = RECORD_SIZE;  // Next byte of s_record to write; RECORD_SIZE = idle
+static int s_next_slot;
+static uint16_t s_next_seq;
+
+static uint8_t crc8(const uint8_t* data, int len) {
+    uint8_t crc = 0;
+    for (int i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void encode_payload(const PersistentData& data, uint8_t* out) {
+    for (int i = 0; i < NUM_GAMES; ++i) {
+        out[i * 2] = data.high_scores[i] & 0xFF;
+        out[i * 2 + 1] = data.high_scores[i] >> 8;
+    }
+    out[NUM_GAMES * 2] = data.brightness;
+}
+
+static void decode_payload(const uint8_t* in, PersistentData& data) {
+    for (int i = 0; i < NUM_GAMES; ++i) {
+        data.high_scores[i] = in[i * 2] | (in[i * 2 + 1] << 8);
+    }
+    data.brightness = in[NUM_GAMES * 2];
+}
+
+static bool same_data(const PersistentData& a, const PersistentData& b) {
+    for (int i = 0; i < NUM_GAMES; ++i) {
+        if (a.high_scores[i] != b.high_scores[i]) return false;
+    }
+    return a.brightness == b.brightness;
+}
+
+static void start_record() {
+    s_record[0] = RECORD_MAGIC;
+    s_record[1] = s_next_seq & 0xFF;
+    s_record[2] = s_next_seq >> 8;
+    encode_payload(s_saved, s_record + 3);
+    s_record[RECORD_SIZE - 1] = crc8(s_record, RECORD_SIZE - 1);
+    s_record_pos = 0;
+    s_dirty = false;
+}
+
+// --- Public API ---
+
+bool persist_load(PersistentData& data) {
+    backend_begin();
+
+    int newest_slot = -1;
+    uint16_t newest_seq = 0;
+    uint8_t record[RECORD_SIZE];
+    for (int slot = 0; slot < NUM_SLOTS; ++slot) {
+        for (int i = 0; i < RECORD_SIZE; ++i) record[i] = backend_read(slot * RECORD_SIZE + i);
+        if (record[0] != RECORD_MAGIC || crc8(record, RECORD_SIZE - 1) != record[RECORD_SIZE - 1]) continue;
+        uint16_t seq = record[1] | (record[2] << 8);
+        // Serial-number comparison, so the sequence may wrap around
+        if (newest_slot < 0 || (int16_t)(seq - newest_seq) > 0) {
+            newest_slot = slot;
+            newest_seq = seq;
+            decode_payload(record + 3, s_saved);
+        }
+    }
+
+    s_record_pos = RECORD_SIZE;
+    s_dirty = false;
+    if (newest_slot < 0) {
+        memset(&s_saved, 0, sizeof(s_saved));
+        s_saved.brightness = DEFAULT_BRIGHTNESS;
+        s_next_slot = 0;
+        s_next_seq = 0;
+    } else {
+        s_next_slot = (newest_slot + 1) % NUM_SLOTS;
+        s_next_seq = newest_seq + 1;
+        // Older builds had other levels; a value off the table would show as "L0"
+        s_saved.brightness = BrightnessGame::nearest_level(s_saved.brightness);
+    }
+    data = s_saved;
+    return newest_slot >= 0;
+}
+
+void persist_save(const PersistentData& data) {
+    if (same_data(data, s_saved)) return;
+    s_saved = data;
+    if (s_record_pos >= RECORD_SIZE) start_record();
+    else s_dirty = true; // Picked up as soon as the current record is complete
+}
+
+void persist_tick() {
+    if (s_record_pos >= RECORD_SIZE || !backend_ready()) return;
+
+    int addr = s_next_slot * RECORD_SIZE + s_record_pos;
+    if (backend_read(addr) != s_record[s_record_pos]) { // Skip bytes that are already right
+        backend_write(addr, s_record[s_record_pos]);
+    }
+    s_record_pos++;
+
+    if (s_record_pos == RECORD_SIZE) {
+        backend_commit();
+        s_next_slot = (s_next_slot + 1) % NUM_SLOTS;
+        s_next_seq++;
+        if (s_dirty) start_record();
+    }
+}
+
+bool persist_busy() {
+    return s_record_pos < RECORD_SIZE;
+}
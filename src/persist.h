@@ -0,0 +1,35 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include "game_logic.h"
+
+// --- Persistent high scores and settings ---
+//
+// Records are written round-robin into a ring of fixed-size slots, each tagged
+// with a 16-bit sequence number and a CRC, so writes are spread over the whole
+// storage and a torn write only loses the newest record. Saving only queues the
+// record; persist_tick() writes at most one byte per frame and never waits for
+// the EEPROM. Backends: AVR EEPROM, Arduino EEPROM library (ESP32 etc.),
+// localStorage on the web, and a file named by $POCHI_EEPROM on native builds
+// (memory only when unset).
+
+#define PERSIST_STORAGE_SIZE 1024 // ATmega328P EEPROM size
+
+struct PersistentData {
+    uint16_t high_scores[NUM_GAMES];
+    uint8_t brightness;
+};
+
+// Reads the newest valid record in a single pass. Returns false (and fills in
+// defaults) when the storage holds none.
+bool persist_load(PersistentData& data);
+
+// Queues data to be written; does nothing if it equals the last saved data.
+void persist_save(const PersistentData& data);
+
+// Writes at most one queued byte. Call once per frame.
+void persist_tick();
+
+bool persist_busy();
+
+#endif // PERSIST_H
@@ -0,0 +1,140 @@
+#include "replay.h"
+#include "game_bot.h" // For GameInstanceStorage sizes and the game classes
+#include "trace.h"
+#include <string.h>
+
+// --- Little-endian helpers ---
+static void put_u16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+static void put_u32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = (value >> (8 * i)) & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+// --- Snapshots ---
+// A game instance is stored as its raw bytes after the vtable pointer, which
+// sits at offset 0 for these single-inheritance classes. Restoring constructs
+// a fresh instance of the same type (for a valid vtable) and copies the bytes over.
+static int instance_size(GameSelection selection) {
+    switch (selection) {
+        case GAME_JUMP: return sizeof(JumpGame);
+        case GAME_CHASE: return sizeof(ChaseGame);
+        case GAME_FILL: return sizeof(FillGame);
+        case GAME_BRIGHTNESS_ADJUSTMENT: return sizeof(BrightnessGame);
+    }
+    return -1;
+}
+
+const int SNAPSHOT_PREFIX_SIZE = 6; // rng state, selection, has instance
+
+int replay_snapshot_size(GameSelection selection, bool has_instance) {
+    int size = SNAPSHOT_PREFIX_SIZE + (int)sizeof(GameState);
+    if (has_instance) size += instance_size(selection) - (int)sizeof(void*);
+    return size;
+}
+
+int replay_write_snapshot(const GameState& state, uint8_t* out) {
+    bool has_instance = state.game_instance != nullptr;
+    put_u32(out, game_rand_state());
+    out[4] = (uint8_t)state.current_selection;
+    out[5] = has_instance ? 1 : 0;
+    memcpy(out + SNAPSHOT_PREFIX_SIZE, &state, sizeof(GameState));
+    int len = SNAPSHOT_PREFIX_SIZE + sizeof(GameState);
+    if (has_instance) {
+        int size = instance_size(state.current_selection) - sizeof(void*);
+        memcpy(out + len, (const uint8_t*)state.game_instance + sizeof(void*), size);
+        len += size;
+    }
+    return len;
+}
+
+int replay_read_snapshot(GameState& state, const uint8_t* in, int len) {
+    if (len < SNAPSHOT_PREFIX_SIZE || in[4] >= NUM_GAMES) return -1;
+    GameSelection selection = (GameSelection)in[4];
+    bool has_instance = in[5] != 0;
+    if (has_instance && instance_size(selection) < 0) return -1;
+    int size = replay_snapshot_size(selection, has_instance);
+    if (len < size) return -1;
+
+    delete state.game_instance;
+    memcpy(&state, in + SNAPSHOT_PREFIX_SIZE, sizeof(GameState));
+    state.game_instance = nullptr;
+    if (has_instance) {
+        TRACE_SUSPEND(); // The constructor's spawns are not real events
+        IGame* game = create_game_instance(selection, state); // Side effects are overwritten below
+        TRACE_RESUME();
+        if (!game) return -1; // Out of memory: the state is left without an instance
+        memcpy((uint8_t*)game + sizeof(void*), in + SNAPSHOT_PREFIX_SIZE + sizeof(GameState),
+               instance_size(selection) - sizeof(void*));
+        memcpy(&state, in + SNAPSHOT_PREFIX_SIZE, sizeof(GameState));
+        state.game_instance = game;
+    }
+    game_srand(get_u32(in));
+    return size;
+}
+
+// --- Recorder ---
+
+static void flush_inputs(ReplayRecorder& recorder) {
+    if (recorder.pending_inputs == 0) return;
+    uint8_t header[3] = {'I'};
+    put_u16(header + 1, recorder.pending_inputs);
+    recorder.write(header, sizeof(header), recorder.ctx);
+    recorder.write(recorder.input_bits, (recorder.pending_inputs + 7) / 8, recorder.ctx);
+    recorder.pending_inputs = 0;
+}
+
+void replay_record_begin(ReplayRecorder& recorder, ReplayWriteFn write, void* ctx,
+                         uint16_t keyframe_interval, uint8_t flags) {
+    // input_bits holds one interval, and 0 would never write a keyframe
+    if (keyframe_interval == 0) keyframe_interval = 1;
+    if (keyframe_interval > REPLAY_DEFAULT_KEYFRAME_INTERVAL) keyframe_interval = REPLAY_DEFAULT_KEYFRAME_INTERVAL;
+    recorder.write = write;
+    recorder.ctx = ctx;
+    recorder.frame = 0;
+    recorder.keyframe_interval = keyframe_interval;
+    recorder.flags = flags;
+    recorder.pending_inputs = 0;
+    frame_stream_encoder_init(recorder.video);
+
+    uint8_t header[REPLAY_HEADER_SIZE] = {'P', 'P', 'R', 'P', REPLAY_VERSION};
+    put_u16(header + 5, sizeof(GameState));
+    put_u16(header + 7, keyframe_interval);
+    header[9] = flags;
+    write(header, sizeof(header), ctx);
+}
+
+void replay_record_input(ReplayRecorder& recorder, const GameState& state, bool button_pressed) {
+    if (recorder.frame % recorder.keyframe_interval == 0) {
+        flush_inputs(recorder);
+        uint8_t chunk[1 + 4 + SNAPSHOT_PREFIX_SIZE + sizeof(GameState) + GAME_INSTANCE_MAX_SIZE];
+        chunk[0] = 'K';
+        put_u32(chunk + 1, recorder.frame);
+        int len = 5 + replay_write_snapshot(state, chunk + 5);
+        recorder.write(chunk, len, recorder.ctx);
+        frame_stream_request_keyframe(recorder.video); // Video can restart at every keyframe too
+    }
+
+    uint16_t i = recorder.pending_inputs++;
+    if ((i & 7) == 0) recorder.input_bits[i >> 3] = 0;
+    if (button_pressed) recorder.input_bits[i >> 3] |= 1 << (i & 7);
+    recorder.frame++;
+}
+
+void replay_record_video(ReplayRecorder& recorder, const GameState& state) {
+    if (!(recorder.flags & REPLAY_FLAG_VIDEO)) return;
+    uint8_t chunk[1 + FRAME_STREAM_MAX_PACKET];
+    chunk[0] = 'D';
+    int len = 1 + frame_stream_encode(recorder.video, state.screen, chunk + 1);
+    recorder.write(chunk, len, recorder.ctx);
+}
+
+void replay_record_end(ReplayRecorder& recorder) {
+    flush_inputs(recorder);
+}
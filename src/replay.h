@@ -0,0 +1,58 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game_logic.h"
+#include "frame_stream.h"
+
+// --- Session recording format ---
+//
+// Header: "PPRP", version, sizeof(GameState) (u16), keyframe interval (u16),
+//         flags (u8). All multi-byte values are little-endian.
+// Chunks, each starting with a tag byte:
+//   'K' keyframe:  frame (u32), rng state (u32), selection (u8), has instance (u8),
+//                  GameState bytes, game instance bytes (without its vtable pointer)
+//   'I' inputs:    frame count (u16), button bits LSB first (as update_game_n)
+//   'D' video:     one frame stream packet (only with REPLAY_FLAG_VIDEO)
+//
+// A keyframe is written every `keyframe_interval` frames, followed by the inputs
+// until the next one, so a player can seek to any frame by restoring the nearest
+// keyframe and simulating at most one interval. Snapshots are raw memory and
+// only valid for the build that wrote them; the header sizes catch most mismatches.
+
+#define REPLAY_VERSION 2
+#define REPLAY_FLAG_VIDEO 0x01 // Also store a frame stream delta per frame
+#define REPLAY_DEFAULT_KEYFRAME_INTERVAL 600 // ~10 s at 60 fps
+#define REPLAY_HEADER_SIZE 10
+
+typedef void (*ReplayWriteFn)(const uint8_t* data, int len, void* ctx);
+
+struct ReplayRecorder {
+    ReplayWriteFn write;
+    void* ctx;
+    uint32_t frame;
+    uint16_t keyframe_interval;
+    uint8_t flags;
+    uint16_t pending_inputs;
+    uint8_t input_bits[REPLAY_DEFAULT_KEYFRAME_INTERVAL / 8 + 1];
+    FrameStreamEncoder video;
+};
+
+// Recording: call replay_record_input() with the button state right before each
+// update_game(), and replay_record_video() right after it. keyframe_interval
+// is clamped to 1..REPLAY_DEFAULT_KEYFRAME_INTERVAL (the header records the
+// clamped value).
+void replay_record_begin(ReplayRecorder& recorder, ReplayWriteFn write, void* ctx,
+                         uint16_t keyframe_interval, uint8_t flags);
+void replay_record_input(ReplayRecorder& recorder, const GameState& state, bool button_pressed);
+void replay_record_video(ReplayRecorder& recorder, const GameState& state);
+void replay_record_end(ReplayRecorder& recorder);
+
+// Snapshots, as stored in 'K' chunks
+int replay_snapshot_size(GameSelection selection, bool has_instance);
+int replay_write_snapshot(const GameState& state, uint8_t* out);
+// Restores a snapshot into state, replacing (and deleting) its game instance.
+// Returns the number of bytes consumed, or -1 if the data is invalid or the
+// instance cannot be allocated.
+int replay_read_snapshot(GameState& state, const uint8_t* in, int len);
+
+#endif // REPLAY_H
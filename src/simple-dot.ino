@@ -1,5 +1,10 @@
 // Core game logic is separated into game_logic.h and game_logic.cpp
 #include "game_logic.h"
+#include "frame_stream.h"
+#include "mem_stats.h"
+#include "idle_governor.h"
+#include "framebuffer_kernels.h"
+#include "led_palette.h"
 
 // NeoPixel Matrix Libraries
 #include <Adafruit_GFX.h>
@@ -9,6 +14,38 @@
 // --- Hardware Configuration ---
 #define PIN 6 // NeoPixel data pin
 #define JUMP_BUTTON_PIN 2 // Use pin 2 for jump
+#define MIRROR_TO_SERIAL 1 // Stream the screen over Serial for host mirroring (tools/stream_viewer)
+#define MIRROR_BAUD 115200
+#define MEM_REPORT_INTERVAL_FRAMES 600 // Memory telemetry on Serial every ~10 s (only without mirroring)
+#define FRAME_INTERVAL_MS 17 // Approximately 58.8 FPS (closer to 60 FPS)
+#define LED_POWER_PIN -1 // Pin driving a switch in the matrix supply (HIGH = on), e.g. 7; -1 if it is always powered
+#define SLEEP_POLL_MS 100 // Boards without a wake-up interrupt check the button this often while asleep
+
+// --- Low Power ---
+// The idle governor (idle_governor.h) slows and dims passive screens and
+// finally asks for sleep. AVR boards sleep in idle mode between frames and
+// in power-down while the governor sleeps, woken by the button's INT0 level
+// interrupt. ESP32 uses light sleep with a GPIO wake-up. Anything else just
+// polls the button. tools/arduino_sim models the AVR path (ARDUINO_SIM).
+#if defined(__AVR__) || defined(ARDUINO_SIM)
+#include <avr/sleep.h>
+#define AVR_SLEEP 1
+#else
+#define AVR_SLEEP 0
+#endif
+#if defined(ESP32)
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+// On dual-core boards the matrix is driven from a task on the other core, so
+// matrix.show() (~8 ms for 256 LEDs) never delays the game tick.
+#if defined(ESP32)
+#define DUAL_CORE_OUTPUT 1
+#define OUTPUT_TASK_CORE 0 // loop() runs on core 1
+#else
+#define DUAL_CORE_OUTPUT 0
+#endif
 
 Adafruit_NeoMatrix matrix = Adafruit_NeoMatrix(16, 16, PIN,
   NEO_MATRIX_TOP     + NEO_MATRIX_LEFT +
@@ -17,34 +54,225 @@ Adafruit_NeoMatrix matrix = Adafruit_NeoMatrix(16, 16, PIN,
 
 // --- Global Game State ---
 GameState gameState;
+IdleGovernor idleGovernor;
+
+#if DUAL_CORE_OUTPUT
+#include "frame_handoff.h"
+FrameHandoff frameHandoff; // loop() publishes, outputTask presents
+uint32_t frameNumber = 0;
+#endif
+
+#if MIRROR_TO_SERIAL
+// --- Serial Mirroring ---
+// One packet is in flight at a time. It is handed to Serial only as fast as the
+// TX buffer has room, so Serial.write never blocks the frame loop; frames that
+// come up while a packet is still draining are simply skipped.
+FrameStreamEncoder streamEncoder;
+uint8_t streamPacket[FRAME_STREAM_MAX_PACKET];
+int streamPacketLen = 0;
+int streamPacketSent = 0;
+
+void mirrorFrame() {
+  if (streamPacketSent >= streamPacketLen) {
+    streamPacketLen = frame_stream_encode(streamEncoder, gameState.screen, streamPacket);
+    streamPacketSent = 0;
+  }
+  int room = Serial.availableForWrite();
+  int remaining = streamPacketLen - streamPacketSent;
+  int n = room < remaining ? room : remaining;
+  if (n > 0) {
+    Serial.write(streamPacket + streamPacketSent, n);
+    streamPacketSent += n;
+  }
+}
+#endif
+
+// --- Palette ---
+// Game colour indexes as RGB, same colours as index.html. Read only by
+// led_palette_build(), so it stays in flash.
+const uint8_t PALETTE_RGB[][3] PROGMEM = {
+  {0, 0, 0},       // 0: Black
+  {255, 0, 0},     // 1: Red
+  {0, 255, 0},     // 2: Green
+  {255, 255, 0},   // 3: Yellow
+  {0, 0, 255},     // 4: Blue
+  {255, 0, 255},   // 5: Magenta
+  {0, 255, 255},   // 6: Cyan
+  {255, 255, 255}, // 7: White
+};
+const int NUM_PALETTE_COLORS = sizeof(PALETTE_RGB) / sizeof(PALETTE_RGB[0]);
+
+// The palette at the shown brightness. Rebuilt only when the brightness changes.
+LedPalette ledPalette;
+int ledPaletteBrightness = -1; // Brightness the tables were built for
+
+// --- Matrix Output ---
+// show() takes ~8 ms of CPU for 256 LEDs, and the LEDs keep showing the last
+// frame on their own, so identical frames are not sent again.
+uint32_t shownHash = 0;
+uint8_t shownBrightness = 0;
+bool shownValid = false; // False after power-up, when the LEDs hold nothing
+
+uint32_t screenHash(const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH]) {
+  uint32_t h = 2166136261u; // FNV-1a
+  for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+    for (int c = 0; c < SCREEN_WIDTH; ++c) {
+      h = (h ^ screen[r][c]) * 16777619u;
+    }
+  }
+  return h;
+}
+
+void presentFrame(const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH], uint8_t brightness) {
+  if (brightness != ledPaletteBrightness) {
+    led_palette_build(ledPalette, PALETTE_RGB, NUM_PALETTE_COLORS, brightness);
+    ledPaletteBrightness = brightness;
+  }
+  uint32_t hash = screenHash(screen);
+  if (shownValid && hash == shownHash && brightness == shownBrightness) return;
+  shownHash = hash;
+  shownBrightness = brightness;
+  shownValid = true;
+
+  // Expand each row through the tables and send the exact 8-bit values
+  // (pass-through skips the RGB565 round trip of drawPixel)
+  uint8_t red[SCREEN_WIDTH], green[SCREEN_WIDTH], blue[SCREEN_WIDTH];
+  for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+    fb_palette_row(screen[r], ledPalette.tables[0], red);
+    fb_palette_row(screen[r], ledPalette.tables[1], green);
+    fb_palette_row(screen[r], ledPalette.tables[2], blue);
+    for (int c = 0; c < SCREEN_WIDTH; ++c) {
+      matrix.setPassThruColor(Adafruit_NeoPixel::Color(red[c], green[c], blue[c]));
+      matrix.drawPixel(c, r, 0);
+    }
+  }
+  matrix.setPassThruColor();
+  matrix.show(); // Update the display with the new data
+}
+
+void setLedPower(bool on) {
+#if LED_POWER_PIN >= 0
+  digitalWrite(LED_POWER_PIN, on ? HIGH : LOW);
+  if (!on) shownValid = false; // Unpowered WS2812s forget their colour
+#else
+  (void)on;
+#endif
+}
 
-// --- Helper function to convert game color index to NeoPixel color ---
-uint16_t getColorFromIndex(uint8_t index) {
-  switch (index) {
-    case 0: return matrix.Color(0, 0, 0);         // 0: Black
-    case 1: return matrix.Color(255, 0, 0);       // 1: Red
-    case 2: return matrix.Color(0, 255, 0);       // 2: Green
-    case 3: return matrix.Color(255, 255, 0);     // 3: Yellow
-    case 4: return matrix.Color(0, 0, 255);       // 4: Blue
-    case 5: return matrix.Color(255, 0, 255);     // 5: Magenta
-    case 6: return matrix.Color(0, 255, 255);     // 6: Cyan
-    case 7: return matrix.Color(255, 255, 255);   // 7: White
-    default: return matrix.Color(0, 0, 0);
+#if DUAL_CORE_OUTPUT
+// Shows the newest published frame; frames that arrive during show() are skipped
+void outputTask(void*) {
+  for (;;) {
+    if (frame_handoff_acquire(frameHandoff)) {
+      const HandoffFrame& frame = frame_handoff_front(frameHandoff);
+      presentFrame(frame.screen, frame.brightness);
+    } else {
+      vTaskDelay(1);
+    }
   }
 }
+#endif
+
+// --- Sleep ---
+#if AVR_SLEEP
+void wakeFromButton() {
+  // A LOW level interrupt fires for as long as the button is held
+  detachInterrupt(digitalPinToInterrupt(JUMP_BUTTON_PIN));
+}
+
+// Idle mode between frames: Timer0's millisecond interrupt wakes the CPU
+void waitForNextFrame(uint16_t interval_ms) {
+  unsigned long start = millis();
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (millis() - start < interval_ms) sleep_mode();
+}
+#else
+void waitForNextFrame(uint16_t interval_ms) {
+  delay(interval_ms);
+}
+#endif
+
+// Blanks the matrix, cuts its power and sleeps until the button is pressed
+void sleepUntilButton() {
+  // Blank through the game's own screen (no 256-byte black frame in SRAM);
+  // the next update_game() redraws it anyway
+  clear_screen(gameState);
+#if DUAL_CORE_OUTPUT
+  frame_handoff_publish_screen(frameHandoff, gameState.screen, 0, frameNumber++, micros());
+  vTaskDelay(pdMS_TO_TICKS(2 * FRAME_INTERVAL_MS)); // Let the output task show it
+#else
+  presentFrame(gameState.screen, 0);
+#endif
+  setLedPower(false);
+  Serial.flush(); // Finish the mirror packet before the UART stops
+
+#if AVR_SLEEP
+  noInterrupts();
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  attachInterrupt(digitalPinToInterrupt(JUMP_BUTTON_PIN), wakeFromButton, LOW);
+  interrupts(); // sei() and sleep_cpu() run back to back, so the wake-up cannot be missed
+  sleep_cpu();
+  sleep_disable();
+#elif defined(ESP32)
+  gpio_wakeup_enable((gpio_num_t)JUMP_BUTTON_PIN, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_light_sleep_start();
+#else
+  while (digitalRead(JUMP_BUTTON_PIN)) delay(SLEEP_POLL_MS);
+#endif
+
+  setLedPower(true);
+}
+
+// --- Memory Telemetry ---
+void reportMemory() {
+  MemStats stats;
+  mem_stats_get(&stats);
+  Serial.print(F("mem stack_hw=")); Serial.print(stats.stack_high_water);
+  Serial.print(F(" free=")); Serial.print(stats.free_ram);
+  Serial.print(F(" heap=")); Serial.print(stats.heap_current);
+  Serial.print(F(" heap_peak=")); Serial.print(stats.heap_peak);
+  Serial.print(F(" alloc_fail=")); Serial.print(stats.heap_failures);
+  Serial.print(F(" GameState=")); Serial.print(stats.sizeof_game_state);
+  Serial.print(F(" Jump=")); Serial.print(stats.sizeof_jump_game);
+  Serial.print(F(" Chase=")); Serial.print(stats.sizeof_chase_game);
+  Serial.print(F(" Fill=")); Serial.print(stats.sizeof_fill_game);
+  Serial.print(F(" Brightness=")); Serial.println(stats.sizeof_brightness_game);
+}
 
 // --- Arduino Setup ---
 void setup() {
+  mem_stats_init(); // Paint the free stack first, so the high-water mark covers everything
+  Serial.begin(MIRROR_BAUD);
+
   matrix.begin();
-  matrix.setBrightness(16);
+  matrix.setBrightness(255); // The brightness is in the palette tables
   // Set up the jump button with an internal pull-up resistor
   pinMode(JUMP_BUTTON_PIN, INPUT_PULLUP);
+#if LED_POWER_PIN >= 0
+  pinMode(LED_POWER_PIN, OUTPUT);
+#endif
+  setLedPower(true);
   
   // Use a disconnected analog pin for a random seed
   randomSeed(analogRead(0));
+  game_srand(analogRead(0) ^ ((uint32_t)micros() << 10));
 
   // Initialize the game state
   set_initial_game(gameState);
+  idle_governor_init(idleGovernor, millis());
+
+#if MIRROR_TO_SERIAL
+  frame_stream_encoder_init(streamEncoder); // The UART carries only the binary stream
+#else
+  reportMemory();
+#endif
+
+#if DUAL_CORE_OUTPUT
+  frame_handoff_init(frameHandoff);
+  xTaskCreatePinnedToCore(outputTask, "matrix", 4096, NULL, 1, NULL, OUTPUT_TASK_CORE);
+#endif
 }
 
 // --- Arduino Loop ---
@@ -53,21 +281,42 @@ void loop() {
   // Button is active-low, so digitalRead is LOW when pressed.
   bool jump_pressed = !digitalRead(JUMP_BUTTON_PIN);
 
+  // Nobody has touched a passive screen for a long time: sleep until they do.
+  // The press that wakes us is swallowed by the governor.
+  if (idle_governor_update(idleGovernor, gameState, jump_pressed, millis()) == POWER_SLEEP) {
+    sleepUntilButton();
+    return;
+  }
+  uint8_t brightness = idle_governor_brightness(idleGovernor, gameState.current_brightness);
+
   // 2. Update Game State
   // The core game logic is handled by this function.
   update_game(gameState, jump_pressed);
 
   // 3. Render the screen
-  // Loop through the game state's screen buffer and draw to the matrix.
-  for (int r = 0; r < SCREEN_HEIGHT; ++r) {
-    for (int c = 0; c < SCREEN_WIDTH; ++c) {
-      uint16_t color = getColorFromIndex(gameState.screen[r][c]);
-      matrix.drawPixel(c, r, color);
-    }
+#if DUAL_CORE_OUTPUT
+  frame_handoff_publish_screen(frameHandoff, gameState.screen, brightness, frameNumber++, micros());
+#else
+  presentFrame(gameState.screen, brightness);
+#endif
+
+#if MIRROR_TO_SERIAL
+  mirrorFrame();
+#else
+  static unsigned int framesSinceReport = 0;
+  if (++framesSinceReport >= MEM_REPORT_INTERVAL_FRAMES) {
+    framesSinceReport = 0;
+    reportMemory();
   }
-  matrix.setBrightness(gameState.current_brightness); // Apply brightness from game state
-  matrix.show(); // Update the display with the new data
+#endif
 
-  // 4. Delay to control frame rate
-  delay(17); // Approximately 58.8 FPS (closer to 60 FPS)
+  // 4. Delay to control frame rate (slower while the governor dims the screen)
+  uint16_t interval = idle_governor_frame_interval_ms(idleGovernor, FRAME_INTERVAL_MS);
+#if DUAL_CORE_OUTPUT
+  // Strict tick: the wait absorbs the frame's own run time
+  static TickType_t lastWake = xTaskGetTickCount();
+  vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(interval));
+#else
+  waitForNextFrame(interval);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "trace.h"
+
+#ifdef POCHI_TRACE
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#elif !defined(__AVR__)
+#include <chrono>
+#endif
+
+// --- Clock ---
+#if defined(ARDUINO)
+static uint32_t clock_us() { return micros(); }
+#elif defined(__EMSCRIPTEN__)
+static uint32_t clock_us() { return (uint32_t)(emscripten_get_now() * 1000.0); }
+#elif defined(__AVR__)
+static uint32_t s_fake_us;
+static uint32_t clock_us() { return s_fake_us++; } // No timer of our own; keeps events ordered
+#else
+static uint32_t clock_us() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+// --- Ring Buffer ---
+// The ring lives in the snapshot struct. trace_snapshot() rotates it into
+// chronological order in place, so exporting needs no second buffer.
+static TraceSnapshot s_ring;
+static uint32_t s_head; // Next slot to write
+static uint32_t s_epoch_us;
+static bool s_started;
+static uint8_t s_suspended;
+
+static const char* const TRACE_EVENT_NAMES[TRACE_NUM_EVENT_TYPES] = {
+    "frame", "frame", "game_switch", "game_start", "game_exit",
+    "phase", "level", "spawn", "collision", "line_clear",
+};
+
+void trace_record(TraceEventType type, int arg) {
+    if (s_suspended) return;
+    uint32_t now = clock_us();
+    if (!s_started) {
+        s_epoch_us = now;
+        s_started = true;
+    }
+    TraceEvent& e = s_ring.events[s_head];
+    e.ts_us = now - s_epoch_us;
+    e.type = (uint16_t)type;
+    e.arg = (int16_t)arg;
+    s_head = (s_head + 1) % TRACE_CAPACITY;
+    if (s_ring.count < TRACE_CAPACITY) s_ring.count++;
+    else s_ring.dropped++;
+}
+
+void trace_clear() {
+    s_ring.count = 0;
+    s_ring.dropped = 0;
+    s_head = 0;
+    s_started = false;
+}
+
+void trace_suspend() { s_suspended++; }
+void trace_resume() { if (s_suspended) s_suspended--; }
+
+static void reverse_events(uint32_t from, uint32_t to) {
+    while (from + 1 < to) {
+        TraceEvent t = s_ring.events[from];
+        s_ring.events[from] = s_ring.events[--to];
+        s_ring.events[to] = t;
+        ++from;
+    }
+}
+
+TraceSnapshot* trace_snapshot() {
+    // Once the ring has wrapped the oldest event is at s_head; rotate it to 0
+    if (s_ring.count == TRACE_CAPACITY && s_head != 0) {
+        reverse_events(0, s_head);
+        reverse_events(s_head, TRACE_CAPACITY);
+        reverse_events(0, TRACE_CAPACITY);
+        s_head = 0;
+    }
+    return &s_ring;
+}
+
+int trace_read(TraceEvent* out, int max) {
+    TraceSnapshot* snap = trace_snapshot();
+    int n = (int)snap->count < max ? (int)snap->count : max;
+    for (int i = 0; i < n; ++i) out[i] = snap->events[i];
+    return n;
+}
+
+uint32_t trace_dropped() {
+    return s_ring.dropped;
+}
+
+const char* trace_event_name(int type) {
+    return (type >= 0 && type < TRACE_NUM_EVENT_TYPES) ? TRACE_EVENT_NAMES[type] : "unknown";
+}
+
+#endif // POCHI_TRACE
@@ -0,0 +1,88 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// --- Event tracing ---
+//
+// Compile with -DPOCHI_TRACE to record game events into a fixed-size ring
+// buffer with microsecond timestamps. Without it the TRACE_* macros expand to
+// nothing (their arguments are not evaluated) and trace.cpp is empty. The
+// native runner writes the buffer as Chrome trace JSON (runner --trace FILE),
+// and the web build (sh build.sh trace) offers it as window.exportTrace(), so
+// both open in chrome://tracing or ui.perfetto.dev.
+//
+// Timestamps are uint32_t microseconds since the first event and wrap after
+// about 71 minutes. When the ring is full the oldest events are overwritten.
+
+// Event types. Keep TRACE_EVENT_NAMES in trace.cpp and main.js in this order.
+enum TraceEventType {
+    TRACE_FRAME_BEGIN,  // arg: current_selection
+    TRACE_FRAME_END,    // arg: 1 if the frame was drawn, 0 if it was swallowed
+    TRACE_GAME_SWITCH,  // arg: new selection (long press on the title)
+    TRACE_GAME_START,   // arg: selection
+    TRACE_GAME_EXIT,    // arg: final score, on the way back to the title
+    TRACE_PHASE,        // arg: new GameplayPhase
+    TRACE_LEVEL,        // arg: new difficulty level
+    TRACE_SPAWN,        // arg: x (Jump obstacle, Fill projectile) or gap lane (Chase wall)
+    TRACE_COLLISION,    // arg: y of the hit (Fill projectile) or -1 for a fatal hit
+    TRACE_LINE_CLEAR,   // arg: row
+    TRACE_NUM_EVENT_TYPES
+};
+
+struct TraceEvent {
+    uint32_t ts_us;
+    uint16_t type; // TraceEventType
+    int16_t arg;
+};
+
+#ifndef TRACE_CAPACITY
+#ifdef __AVR__
+#define TRACE_CAPACITY 32
+#else
+#define TRACE_CAPACITY 4096
+#endif
+#endif
+
+#ifdef POCHI_TRACE
+
+// Snapshot of the ring in chronological order, for the WASM module. All
+// fields are uint32_t-sized so JS can read the header from HEAPU32.
+struct TraceSnapshot {
+    uint32_t count;   // Valid events in `events`
+    uint32_t dropped; // Oldest events lost to ring overwrite
+    TraceEvent events[TRACE_CAPACITY];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void trace_record(TraceEventType type, int arg);
+void trace_clear();
+// Events recorded while suspended (e.g. bot rollouts on cloned games) are ignored. Nests.
+void trace_suspend();
+void trace_resume();
+// Copies the events oldest-first into out (up to max) and returns how many were copied
+int trace_read(TraceEvent* out, int max);
+uint32_t trace_dropped();
+TraceSnapshot* trace_snapshot();
+const char* trace_event_name(int type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define TRACE_EVENT(type, arg) trace_record((type), (int)(arg))
+#define TRACE_SUSPEND() trace_suspend()
+#define TRACE_RESUME() trace_resume()
+
+#else
+
+#define TRACE_EVENT(type, arg) ((void)0)
+#define TRACE_SUSPEND() ((void)0)
+#define TRACE_RESUME() ((void)0)
+
+#endif // POCHI_TRACE
+
+#endif // TRACE_H
@@ -0,0 +1,596 @@
+// Host-side Arduino/NeoPixel emulation: runs src/simple-dot.ino unmodified.
+//
+// The Arduino core and NeoPixel headers in tools/arduino/include are replaced
+// by stand-ins that run on a virtual clock. Only the timing model moves the
+// clock, so runs are deterministic unless --cpu-scale is used:
+//   delay()/delayMicroseconds()  advance by the requested time
+//   matrix.show()                advances by LEDs * --led-us + --reset-us (WS2812 transfer)
+//   Serial.write()               blocks like the real TX buffer when it is full,
+//                                and the buffer drains at the configured baud rate
+//   each loop()                  costs --loop-us of CPU time, plus the host CPU time
+//                                of the sketch scaled by --cpu-scale
+// The button is driven by the scripted input from tools/input_script.h, one
+// sample per loop(). Every press/release is placed at a random point in the
+// previous loop iteration, like a real finger, and its input-to-LED latency
+// is measured until the next show() after the sketch read it.
+//
+// Energy model: the MCU draws --mcu-active-ma while running (delay() busy-waits
+// like the real core), --mcu-idle-ma in SLEEP_MODE_IDLE and --mcu-sleep-ma in
+// SLEEP_MODE_PWR_DOWN. Each WS2812 draws --led-idle-ma plus --led-channel-ma per
+// channel at full duty, scaled by the colour and setBrightness(), from the last
+// show() on, and nothing while --led-power-pin is LOW. The defaults are
+// ATmega328P datasheet figures at 16 MHz/5 V and typical WS2812B measurements;
+// pass your own board's measured currents to get its numbers.
+// --idle-seconds T leaves the button alone for T seconds after the scripted
+// frames (a unit left on the shelf), reports the average current and battery
+// life for that stretch, then presses the button once to check that the
+// sketch wakes up.
+//
+//   arduino_sim [--game N] [--seed S] [--frames F] [--led-us U] [--reset-us U]
+//               [--loop-us U] [--cpu-scale X] [--serial] [--idle-seconds T]
+//               [--battery-mah C] [--mcu-active-ma I] [--mcu-idle-ma I] [--mcu-sleep-ma I]
+//               [--led-idle-ma I] [--led-channel-ma I] [--led-power-pin P]
+// --serial writes the sketch's Serial output to stdout, e.g.
+//   ./build/arduino_sim --serial | ./build/stream_viewer
+// The report goes to stderr.
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <Adafruit_NeoMatrix.h>
+#include "input_script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+// The sketch (compiled from src/simple-dot.ino)
+void setup();
+void loop();
+
+// --- Timing Model ---
+struct TimingModel {
+    double led_us;        // Transfer time per LED (24 bits at 800 kHz = 30 us)
+    double reset_us;      // Latch gap after the last LED
+    double loop_us;       // Fixed CPU cost of one loop() outside the shim calls
+    double cpu_scale;     // Host CPU time of the sketch is multiplied by this (0 = ignored)
+    uint32_t tx_buffer;   // Serial TX buffer size in bytes
+};
+
+static TimingModel s_model = {30.0, 80.0, 0.0, 0.0, 64};
+
+// --- Energy Model ---
+enum McuState {
+    MCU_ACTIVE,
+    MCU_IDLE,       // SLEEP_MODE_IDLE
+    MCU_POWER_DOWN, // SLEEP_MODE_PWR_DOWN
+    NUM_MCU_STATES
+};
+
+struct EnergyModel {
+    double mcu_ma[NUM_MCU_STATES];
+    double led_idle_ma;    // Per LED, even when dark
+    double led_channel_ma; // Per colour channel at 255
+    double battery_mah;
+    int led_power_pin;     // -1: the matrix is always powered
+};
+
+static EnergyModel s_energy_model = {{9.5, 2.6, 0.005}, 0.6, 12.0, 2000.0, -1};
+
+struct EnergyStats {
+    double mcu_charge[NUM_MCU_STATES]; // mA * ns
+    double led_charge;
+    uint64_t time_ns[NUM_MCU_STATES];
+};
+
+static EnergyStats s_energy;
+static bool s_led_powered = true;
+static double s_led_ma = 0;    // Drawn by the matrix with its current contents
+static uint16_t s_num_leds = 0;
+
+// --- Virtual Clock ---
+typedef std::chrono::steady_clock HostClock;
+static uint64_t s_now_ns = 0;
+static HostClock::time_point s_host_mark;
+
+// Every advance of the clock goes through here, so time and charge always add up
+static void spend_ns(uint64_t ns, McuState state) {
+    s_now_ns += ns;
+    s_energy.time_ns[state] += ns;
+    s_energy.mcu_charge[state] += ns * s_energy_model.mcu_ma[state];
+    if (s_led_powered) s_energy.led_charge += ns * s_led_ma;
+}
+
+// Charges the sketch's own host CPU time since the last shim call (if enabled)
+static void charge_cpu() {
+    HostClock::time_point host_now = HostClock::now();
+    if (s_model.cpu_scale > 0) {
+        double host_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(host_now - s_host_mark).count();
+        spend_ns((uint64_t)(host_ns * s_model.cpu_scale), MCU_ACTIVE);
+    }
+    s_host_mark = host_now;
+}
+
+static void advance_us(double us) {
+    spend_ns((uint64_t)(us * 1000.0), MCU_ACTIVE);
+}
+
+// --- Statistics ---
+const int MAX_PENDING_EDGES = 8;
+
+struct PendingEdge {
+    uint64_t time_ns;
+    bool sampled; // The sketch has read the new button state
+};
+
+struct ShimStats {
+    uint32_t shows;
+    uint64_t show_ns;
+    uint32_t edges;
+    uint32_t edges_dropped; // More unsampled edges than MAX_PENDING_EDGES
+    uint64_t latency_sum_ns;
+    uint64_t latency_min_ns;
+    uint64_t latency_max_ns;
+    uint32_t serial_bytes;
+    uint64_t serial_blocked_ns;
+};
+
+static ShimStats s_stats;
+static PendingEdge s_edges[MAX_PENDING_EDGES];
+static int s_num_edges = 0;
+
+// --- Pins and Randomness ---
+static bool s_button_pressed = false;
+static uint8_t s_pin_modes[64];
+static uint32_t s_rng = 1;
+
+static uint32_t shim_random() {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < sizeof(s_pin_modes)) s_pin_modes[pin] = mode;
+}
+
+// Any pull-up input is the button (active low)
+int digitalRead(uint8_t pin) {
+    charge_cpu();
+    if (pin >= sizeof(s_pin_modes) || s_pin_modes[pin] != INPUT_PULLUP) return LOW;
+    for (int i = 0; i < s_num_edges; ++i) s_edges[i].sampled = true;
+    return s_button_pressed ? LOW : HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    charge_cpu();
+    if ((int)pin != s_energy_model.led_power_pin) return;
+    bool on = value != LOW;
+    if (on && !s_led_powered) s_led_ma = s_num_leds * s_energy_model.led_idle_ma; // Powered up dark
+    s_led_powered = on;
+}
+
+int analogRead(uint8_t) {
+    charge_cpu();
+    return (int)(shim_random() & 1023); // A floating pin
+}
+
+unsigned long millis() {
+    charge_cpu();
+    return (uint32_t)(s_now_ns / 1000000); // Wraps at 32 bits like the real core
+}
+
+unsigned long micros() {
+    charge_cpu();
+    return (uint32_t)(s_now_ns / 1000);
+}
+
+void delay(unsigned long ms) {
+    charge_cpu();
+    advance_us(ms * 1000.0);
+}
+
+void delayMicroseconds(unsigned int us) {
+    charge_cpu();
+    advance_us(us);
+}
+
+// Every edge the sketch has read is now visible on the LEDs: called from show(),
+// and after a loop() that skipped show() because the frame did not change
+static void settle_edges() {
+    int kept = 0;
+    for (int i = 0; i < s_num_edges; ++i) {
+        if (!s_edges[i].sampled) {
+            s_edges[kept++] = s_edges[i];
+            continue;
+        }
+        uint64_t latency = s_now_ns - s_edges[i].time_ns;
+        s_stats.latency_sum_ns += latency;
+        if (latency < s_stats.latency_min_ns) s_stats.latency_min_ns = latency;
+        if (latency > s_stats.latency_max_ns) s_stats.latency_max_ns = latency;
+        s_stats.edges++;
+    }
+    s_num_edges = kept;
+}
+
+// --- Sleep and the Button Interrupt ---
+// The button is the only interrupt source modelled. In power-down it ends the
+// sleep at s_wake_at_ns, when the main loop presses the button; without a
+// scheduled press (during the scripted frames) one power-down lasts one frame.
+const uint64_t UNSCHEDULED_SLEEP_NS = 17000000;
+
+static int s_sleep_mode = SLEEP_MODE_IDLE;
+static bool s_sleep_enabled = false;
+static void (*s_button_handler)() = NULL;
+static uint64_t s_wake_at_ns = UINT64_MAX;
+static bool s_wake_pending = false; // Set when the scheduled press happens, until the next show()
+static uint64_t s_wake_latency_ns = 0;
+static bool s_led_powered_in_sleep = false;
+
+static void press_for_wake() {
+    s_button_pressed = true;
+    s_wake_pending = true;
+    s_wake_at_ns = s_now_ns; // From here to the next show() is the wake latency
+}
+
+void attachInterrupt(int interrupt, void (*handler)(), int) {
+    if (interrupt == 0) s_button_handler = handler;
+}
+
+void detachInterrupt(int interrupt) {
+    if (interrupt == 0) s_button_handler = NULL;
+}
+
+void set_sleep_mode(int mode) { s_sleep_mode = mode; }
+void sleep_enable() { s_sleep_enabled = true; }
+void sleep_disable() { s_sleep_enabled = false; }
+
+void sleep_cpu() {
+    charge_cpu();
+    if (!s_sleep_enabled) return;
+    if (s_sleep_mode == SLEEP_MODE_IDLE) {
+        // Timer0 wakes the CPU every millisecond
+        spend_ns(1000000 - s_now_ns % 1000000, MCU_IDLE);
+    } else if (!s_button_pressed) {
+        uint64_t until = s_wake_at_ns != UINT64_MAX ? s_wake_at_ns : s_now_ns + UNSCHEDULED_SLEEP_NS;
+        s_led_powered_in_sleep = s_led_powered;
+        if (until > s_now_ns) spend_ns(until - s_now_ns, MCU_POWER_DOWN);
+        if (s_now_ns >= s_wake_at_ns) press_for_wake();
+    }
+    if (s_button_pressed && s_button_handler) s_button_handler(); // LOW level interrupt
+    s_host_mark = HostClock::now(); // Host time spent asleep is not sketch CPU time
+}
+
+void randomSeed(unsigned long seed) {
+    s_rng = seed ? (uint32_t)seed : 1;
+}
+
+long random(long max) {
+    return max > 0 ? (long)(shim_random() % (uint32_t)max) : 0;
+}
+
+long random(long min, long max) {
+    return min + random(max - min);
+}
+
+// --- Serial ---
+HardwareSerial Serial;
+static double s_ns_per_byte = 0; // 0 until begin()
+static uint32_t s_tx_queued = 0;
+static uint64_t s_tx_drained_ns = 0;
+static bool s_serial_to_stdout = false;
+
+static void drain_tx() {
+    if (s_ns_per_byte <= 0 || s_tx_queued == 0) {
+        s_tx_drained_ns = s_now_ns;
+        return;
+    }
+    uint64_t sent = (uint64_t)((s_now_ns - s_tx_drained_ns) / s_ns_per_byte);
+    if (sent >= s_tx_queued) {
+        s_tx_queued = 0;
+        s_tx_drained_ns = s_now_ns;
+    } else {
+        s_tx_queued -= (uint32_t)sent;
+        s_tx_drained_ns += (uint64_t)(sent * s_ns_per_byte);
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+    s_ns_per_byte = 1e9 * 10 / baud; // Start + 8 data + stop bits
+    s_tx_queued = 0;
+    s_tx_drained_ns = s_now_ns;
+}
+
+int HardwareSerial::availableForWrite() {
+    charge_cpu();
+    drain_tx();
+    return (int)(s_model.tx_buffer - s_tx_queued);
+}
+
+void HardwareSerial::flush() {
+    charge_cpu();
+    drain_tx();
+    if (s_tx_queued == 0) return;
+    uint64_t done = s_tx_drained_ns + (uint64_t)(s_tx_queued * s_ns_per_byte);
+    if (done > s_now_ns) spend_ns(done - s_now_ns, MCU_ACTIVE);
+    drain_tx();
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+    return write(&byte, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    charge_cpu();
+    for (size_t i = 0; i < size; ++i) {
+        drain_tx();
+        if (s_tx_queued >= s_model.tx_buffer) {
+            // Full: block until the oldest byte has gone out
+            uint64_t wait = s_tx_drained_ns + (uint64_t)s_ns_per_byte - s_now_ns;
+            s_stats.serial_blocked_ns += wait;
+            spend_ns(wait, MCU_ACTIVE);
+            drain_tx();
+        }
+        s_tx_queued++;
+        if (s_serial_to_stdout) putchar(buffer[i]);
+    }
+    s_stats.serial_bytes += (uint32_t)size;
+    return size;
+}
+
+size_t HardwareSerial::print(const __FlashStringHelper* text) {
+    return print(reinterpret_cast<const char*>(text));
+}
+
+size_t HardwareSerial::print(const char* text) {
+    return write((const uint8_t*)text, strlen(text));
+}
+
+size_t HardwareSerial::print(long value) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    return print(buffer);
+}
+
+size_t HardwareSerial::print(unsigned long value) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%lu", value);
+    return print(buffer);
+}
+
+// --- NeoPixel ---
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t num_leds, int16_t, uint16_t)
+    : m_num_leds(num_leds), m_brightness(255), m_pixels(new uint32_t[num_leds]()) {
+    s_num_leds = num_leds;
+    s_led_ma = num_leds * s_energy_model.led_idle_ma;
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+    delete[] m_pixels;
+}
+
+void Adafruit_NeoPixel::show() {
+    charge_cpu();
+    uint64_t start = s_now_ns;
+    advance_us(m_num_leds * s_model.led_us + s_model.reset_us);
+    s_stats.shows++;
+    s_stats.show_ns += s_now_ns - start;
+
+    // The new colours draw current from the end of the transfer on
+    uint32_t duty_sum = 0;
+    for (uint16_t i = 0; i < m_num_leds; ++i) {
+        uint32_t c = m_pixels[i];
+        duty_sum += ((c >> 16) & 0xFF) + ((c >> 8) & 0xFF) + (c & 0xFF);
+    }
+    s_led_ma = m_num_leds * s_energy_model.led_idle_ma +
+               s_energy_model.led_channel_ma * duty_sum / 255.0 * m_brightness / 255.0;
+
+    if (s_wake_pending) {
+        s_wake_latency_ns = s_now_ns - s_wake_at_ns;
+        s_wake_pending = false;
+    }
+    settle_edges();
+}
+
+// Column-major zigzag and friends, as selected by the NEO_MATRIX_* flags
+void Adafruit_NeoMatrix::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return;
+    if (m_matrix_type & NEO_MATRIX_RIGHT) x = m_width - 1 - x;
+    if (m_matrix_type & NEO_MATRIX_BOTTOM) y = m_height - 1 - y;
+    int index;
+    if (m_matrix_type & NEO_MATRIX_COLUMNS) {
+        if ((m_matrix_type & NEO_MATRIX_ZIGZAG) && (x & 1)) y = m_height - 1 - y;
+        index = x * m_height + y;
+    } else {
+        if ((m_matrix_type & NEO_MATRIX_ZIGZAG) && (y & 1)) x = m_width - 1 - x;
+        index = y * m_width + x;
+    }
+    if (m_pass_thru) {
+        setPixelColor(index, m_pass_thru_color);
+        return;
+    }
+    // RGB565 back to 8 bits per channel
+    uint8_t r = (color >> 11) << 3, g = ((color >> 5) & 0x3F) << 2, b = (color & 0x1F) << 3;
+    setPixelColor(index, Adafruit_NeoPixel::Color(r, g, b));
+}
+
+// --- Main ---
+const int WAKE_PRESS_LOOPS = 5; // How long the wake press is held
+const int WAKE_LOOPS = 60;      // Give up on waking after this many loops
+
+static void report_energy(const char* phase, const EnergyStats& e, uint64_t span_ns) {
+    if (span_ns == 0) return;
+    double mcu = 0;
+    for (int k = 0; k < NUM_MCU_STATES; ++k) mcu += e.mcu_charge[k];
+    double mcu_ma = mcu / span_ns, led_ma = e.led_charge / span_ns;
+    double total_ma = mcu_ma + led_ma;
+    double hours = span_ns / 3.6e12;
+    fprintf(stderr, "%s: %.1f s, avg %.3f mA (MCU %.3f, LEDs %.3f), %.4f mAh; MCU active %.1f%%, idle %.1f%%, "
+                    "power-down %.1f%%\n", phase, span_ns / 1e9, total_ma, mcu_ma, led_ma, total_ma * hours,
+            100.0 * e.time_ns[MCU_ACTIVE] / span_ns, 100.0 * e.time_ns[MCU_IDLE] / span_ns,
+            100.0 * e.time_ns[MCU_POWER_DOWN] / span_ns);
+    if (total_ma > 0) {
+        double life_h = s_energy_model.battery_mah / total_ma;
+        fprintf(stderr, "  battery life at this draw: %.1f h (%.1f days)\n", life_h, life_h / 24);
+    }
+}
+
+int main(int argc, char** argv) {
+    int game = 0;
+    uint32_t seed = 1;
+    long frames = 1800;
+    double idle_seconds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--game") && i + 1 < argc) {
+            game = atoi(argv[++i]) % 4;
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--led-us") && i + 1 < argc) {
+            s_model.led_us = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--reset-us") && i + 1 < argc) {
+            s_model.reset_us = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--loop-us") && i + 1 < argc) {
+            s_model.loop_us = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--cpu-scale") && i + 1 < argc) {
+            s_model.cpu_scale = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--serial")) {
+            s_serial_to_stdout = true;
+        } else if (!strcmp(argv[i], "--idle-seconds") && i + 1 < argc) {
+            idle_seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--battery-mah") && i + 1 < argc) {
+            s_energy_model.battery_mah = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--mcu-active-ma") && i + 1 < argc) {
+            s_energy_model.mcu_ma[MCU_ACTIVE] = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--mcu-idle-ma") && i + 1 < argc) {
+            s_energy_model.mcu_ma[MCU_IDLE] = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--mcu-sleep-ma") && i + 1 < argc) {
+            s_energy_model.mcu_ma[MCU_POWER_DOWN] = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--led-idle-ma") && i + 1 < argc) {
+            s_energy_model.led_idle_ma = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--led-channel-ma") && i + 1 < argc) {
+            s_energy_model.led_channel_ma = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--led-power-pin") && i + 1 < argc) {
+            s_energy_model.led_power_pin = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--game N] [--seed S] [--frames F] [--led-us U] [--reset-us U] "
+                            "[--loop-us U] [--cpu-scale X] [--serial] [--idle-seconds T] [--battery-mah C] "
+                            "[--mcu-active-ma I] [--mcu-idle-ma I] [--mcu-sleep-ma I] [--led-idle-ma I] "
+                            "[--led-channel-ma I] [--led-power-pin P]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.latency_min_ns = UINT64_MAX;
+    memset(&s_energy, 0, sizeof(s_energy));
+    s_led_powered = s_energy_model.led_power_pin < 0; // The pin is LOW out of reset
+    s_rng = seed;
+    InputScript script;
+    input_script_init(script, game, seed);
+
+    s_host_mark = HostClock::now();
+    setup();
+
+    uint64_t loop_start = s_now_ns;
+    uint64_t prev_loop_start = s_now_ns;
+    for (long frame = 0; frame < frames; ++frame) {
+        bool pressed = input_script_next(script);
+        if (pressed != s_button_pressed) {
+            // The finger moved at some point during the previous iteration
+            uint64_t span = loop_start - prev_loop_start;
+            uint64_t edge = prev_loop_start + (span ? shim_random() % span : 0);
+            if (s_num_edges < MAX_PENDING_EDGES) {
+                s_edges[s_num_edges].time_ns = edge;
+                s_edges[s_num_edges].sampled = false;
+                s_num_edges++;
+            } else {
+                s_stats.edges_dropped++;
+            }
+            s_button_pressed = pressed;
+        }
+
+        charge_cpu();
+        loop();
+        charge_cpu();
+        settle_edges();
+        advance_us(s_model.loop_us);
+
+        prev_loop_start = loop_start;
+        loop_start = s_now_ns;
+    }
+    uint64_t played_ns = s_now_ns;
+    EnergyStats played = s_energy;
+
+    // Hands off for idle_seconds, then one press to wake the board up
+    EnergyStats idle;
+    uint64_t idle_ns = 0;
+    bool woke = false;
+    if (idle_seconds > 0) {
+        uint64_t idle_start = s_now_ns;
+        s_button_pressed = false;
+        s_wake_at_ns = s_now_ns + (uint64_t)(idle_seconds * 1e9);
+        s_wake_latency_ns = 0;
+        while (s_now_ns < s_wake_at_ns) {
+            charge_cpu();
+            loop();
+            charge_cpu();
+            advance_us(s_model.loop_us);
+        }
+        idle_ns = s_now_ns - idle_start;
+        idle = s_energy;
+        for (int k = 0; k < NUM_MCU_STATES; ++k) {
+            idle.mcu_charge[k] -= played.mcu_charge[k];
+            idle.time_ns[k] -= played.time_ns[k];
+        }
+        idle.led_charge -= played.led_charge;
+
+        if (!s_wake_pending && !s_button_pressed) press_for_wake(); // Still awake: press anyway
+        for (int k = 0; k < WAKE_LOOPS && s_wake_pending; ++k) {
+            charge_cpu();
+            loop();
+            charge_cpu();
+            advance_us(s_model.loop_us);
+            if (k == WAKE_PRESS_LOOPS) s_button_pressed = false;
+        }
+        woke = !s_wake_pending;
+    }
+    fflush(stdout);
+
+    double seconds = played_ns / 1e9;
+    fprintf(stderr, "timing model: %.1f us/LED, %.1f us reset, %.1f us/loop, cpu scale %.2f\n",
+            s_model.led_us, s_model.reset_us, s_model.loop_us, s_model.cpu_scale);
+    fprintf(stderr, "%ld frames in %.2f s virtual: %.1f fps\n", frames, seconds, seconds > 0 ? frames / seconds : 0.0);
+    if (s_stats.shows) {
+        fprintf(stderr, "show(): %u calls, %.3f ms each, %.1f%% of the time\n", s_stats.shows,
+                s_stats.show_ns / 1e6 / s_stats.shows, 100.0 * s_stats.show_ns / s_now_ns);
+    }
+    if (s_stats.edges) {
+        fprintf(stderr, "input-to-LED latency: %u edges, min %.2f ms, avg %.2f ms, max %.2f ms\n", s_stats.edges,
+                s_stats.latency_min_ns / 1e6, s_stats.latency_sum_ns / 1e6 / s_stats.edges,
+                s_stats.latency_max_ns / 1e6);
+    }
+    if (s_stats.edges_dropped) fprintf(stderr, "(%u edges not measured)\n", s_stats.edges_dropped);
+    fprintf(stderr, "serial: %u bytes, blocked %.2f ms\n", s_stats.serial_bytes, s_stats.serial_blocked_ns / 1e6);
+
+    fprintf(stderr, "energy model: MCU %.3g/%.3g/%.3g mA active/idle/power-down, LED %.3g mA + %.3g mA/channel, "
+                    "battery %.0f mAh\n", s_energy_model.mcu_ma[MCU_ACTIVE], s_energy_model.mcu_ma[MCU_IDLE],
+            s_energy_model.mcu_ma[MCU_POWER_DOWN], s_energy_model.led_idle_ma, s_energy_model.led_channel_ma,
+            s_energy_model.battery_mah);
+    report_energy("playing", played, played_ns);
+    if (idle_seconds > 0) {
+        report_energy("idle", idle, idle_ns);
+        if (idle.time_ns[MCU_POWER_DOWN]) {
+            // Power-down with the matrix switched off: what a unit left asleep draws
+            double asleep_ma = s_energy_model.mcu_ma[MCU_POWER_DOWN] +
+                               (s_led_powered_in_sleep ? s_num_leds * s_energy_model.led_idle_ma : 0);
+            fprintf(stderr, "asleep: %.3f mA, battery life %.0f days\n", asleep_ma,
+                    s_energy_model.battery_mah / asleep_ma / 24);
+        }
+        if (woke) fprintf(stderr, "wake: first frame %.2f ms after the press\n", s_wake_latency_ns / 1e6);
+        else fprintf(stderr, "wake: no frame within %d loops of the press\n", WAKE_LOOPS);
+    }
+    return woke || idle_seconds <= 0 ? 0 : 1;
+}
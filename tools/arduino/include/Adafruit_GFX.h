@@ -0,0 +1,20 @@
+#ifndef ADAFRUIT_GFX_H
+#define ADAFRUIT_GFX_H
+
+// Host stand-in: only the drawPixel interface the sketch needs
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : m_width(w), m_height(h) {}
+    virtual ~Adafruit_GFX() {}
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    int16_t width() const { return m_width; }
+    int16_t height() const { return m_height; }
+
+protected:
+    int16_t m_width;
+    int16_t m_height;
+};
+
+#endif // ADAFRUIT_GFX_H
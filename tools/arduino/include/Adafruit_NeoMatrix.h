@@ -0,0 +1,40 @@
+#ifndef ADAFRUIT_NEOMATRIX_H
+#define ADAFRUIT_NEOMATRIX_H
+
+// Host stand-in for a single NeoPixel matrix (no tiling).
+#include <Adafruit_GFX.h>
+#include <Adafruit_NeoPixel.h>
+
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+
+class Adafruit_NeoMatrix : public Adafruit_GFX, public Adafruit_NeoPixel {
+public:
+    Adafruit_NeoMatrix(int w, int h, uint8_t pin, uint8_t matrix_type, uint16_t led_type)
+        : Adafruit_GFX(w, h), Adafruit_NeoPixel(w * h, pin, led_type), m_matrix_type(matrix_type),
+          m_pass_thru(false), m_pass_thru_color(0) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+
+    // While set, drawPixel() ignores its RGB565 colour and stores this 0xRRGGBB one
+    void setPassThruColor(uint32_t color) { m_pass_thru = true; m_pass_thru_color = color; }
+    void setPassThruColor() { m_pass_thru = false; }
+
+    // RGB565, like the real library
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+    }
+
+private:
+    uint8_t m_matrix_type;
+    bool m_pass_thru;
+    uint32_t m_pass_thru_color;
+};
+
+#endif // ADAFRUIT_NEOMATRIX_H
@@ -0,0 +1,32 @@
+#ifndef ADAFRUIT_NEOPIXEL_H
+#define ADAFRUIT_NEOPIXEL_H
+
+// Host stand-in for a WS2812 strip. show() costs virtual time according to the
+// timing model (per-LED transfer time plus the latch/reset gap).
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t num_leds, int16_t pin, uint16_t type);
+    virtual ~Adafruit_NeoPixel();
+    void begin() {}
+    void show();
+    void setBrightness(uint8_t brightness) { m_brightness = brightness; }
+    uint8_t getBrightness() const { return m_brightness; }
+    void setPixelColor(uint16_t n, uint32_t rgb) { if (n < m_num_leds) m_pixels[n] = rgb; }
+    uint32_t getPixelColor(uint16_t n) const { return n < m_num_leds ? m_pixels[n] : 0; }
+    uint16_t numPixels() const { return m_num_leds; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+
+private:
+    uint16_t m_num_leds;
+    uint8_t m_brightness;
+    uint32_t* m_pixels;   // 0xRRGGBB before brightness scaling
+};
+
+#endif // ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,65 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core that simple-dot.ino uses.
+// Time is virtual and follows the timing model in tools/arduino/arduino_shim.cpp.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// Strings and PROGMEM data stay in RAM on the host
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void randomSeed(unsigned long seed);
+long random(long max);
+long random(long min, long max);
+
+// --- Interrupts ---
+// Only the button's wake-up interrupt is modelled (see sleep_cpu() in the shim)
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+static inline int digitalPinToInterrupt(uint8_t pin) { return pin == 2 ? 0 : pin == 3 ? 1 : -1; }
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+void detachInterrupt(int interrupt);
+static inline void noInterrupts() {}
+static inline void interrupts() {}
+
+// --- Serial ---
+// A TX buffer that drains at the configured baud rate in virtual time.
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    int availableForWrite();
+    void flush(); // Blocks until the TX buffer has drained
+    size_t write(uint8_t byte);
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t print(const __FlashStringHelper* text);
+    size_t print(const char* text);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(int value) { return print((long)value); }
+    size_t print(unsigned int value) { return print((unsigned long)value); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + print("\r\n"); }
+    size_t println() { return print("\r\n"); }
+};
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_H
@@ -0,0 +1,18 @@
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+// Host stand-in for avr-libc's sleep API. The shim charges sleep time at the
+// current of the selected mode (see the energy model in arduino_shim.cpp):
+//   SLEEP_MODE_IDLE     until the next Timer0 millisecond tick
+//   SLEEP_MODE_PWR_DOWN until the button's interrupt would fire
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+void set_sleep_mode(int mode);
+void sleep_enable();
+void sleep_disable();
+void sleep_cpu();
+static inline void sleep_mode() { sleep_enable(); sleep_cpu(); sleep_disable(); }
+
+#endif // AVR_SLEEP_H
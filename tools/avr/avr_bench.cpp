@@ -0,0 +1,147 @@
+// Cycle-accurate frame benchmark for ATmega328P, meant to run under simavr.
+//
+// Replays the same scripted input as tools/runner.cpp through update_game()
+// for every game and measures each frame with Timer1 running at the CPU clock.
+// Per game and phase it prints min/avg/max cycles over the UART, plus the
+// share of the ~17 ms frame budget of simple-dot.ino. Build and run with
+// build_avr.sh.
+
+#include "game_logic.h"
+#include "../input_script.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// --- Bench Constants ---
+const int BENCH_FRAMES_PER_GAME = 1500;
+const uint32_t FRAME_BUDGET_CYCLES = F_CPU / 1000 * 17; // delay(17) in simple-dot.ino
+const char* const GAME_NAMES[NUM_GAMES] = {"jump", "chase", "fill", "brightness"};
+
+enum BenchPhase { BENCH_TITLE, BENCH_COUNTDOWN, BENCH_PLAYING, BENCH_GAMEOVER, NUM_BENCH_PHASES };
+const char* const PHASE_NAMES[NUM_BENCH_PHASES] = {"title", "countdown", "playing", "gameover"};
+
+// --- C++ runtime pieces the Arduino core would normally provide ---
+void* operator new(size_t size) { return malloc(size); }
+void operator delete(void* ptr) { free(ptr); }
+void operator delete(void* ptr, size_t) { free(ptr); }
+extern "C" void __cxa_pure_virtual() { while (true); }
+
+// --- Cycle Counter ---
+// Timer1 counts every CPU cycle; overflows extend it to 32 bits.
+static volatile uint16_t s_timer_overflows;
+
+ISR(TIMER1_OVF_vect) { s_timer_overflows++; }
+
+static void cycle_counter_init() {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10); // No prescaler
+    TIMSK1 = _BV(TOIE1);
+    sei();
+}
+
+static uint32_t read_cycles() {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = s_timer_overflows;
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++; // Overflow pending but not yet serviced
+    SREG = sreg;
+    return ((uint32_t)high << 16) | low;
+}
+
+// --- UART (simavr echoes it to the console) ---
+static int uart_putchar(char c, FILE*) {
+    if (c == '\n') uart_putchar('\r', NULL);
+    while (!(UCSR0A & _BV(UDRE0)));
+    UDR0 = c;
+    return 0;
+}
+
+static FILE s_uart_out;
+
+static void uart_init() {
+    const uint16_t ubrr = F_CPU / 16 / 115200 - 1;
+    UBRR0H = ubrr >> 8;
+    UBRR0L = ubrr & 0xFF;
+    UCSR0B = _BV(TXEN0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+    fdev_setup_stream(&s_uart_out, uart_putchar, NULL, _FDEV_SETUP_WRITE);
+    stdout = &s_uart_out;
+}
+
+// --- Statistics ---
+struct PhaseStats {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t count;
+};
+
+static void add_sample(PhaseStats& stats, uint32_t cycles) {
+    if (stats.count == 0 || cycles < stats.min) stats.min = cycles;
+    if (cycles > stats.max) stats.max = cycles;
+    stats.sum += cycles;
+    stats.count++;
+}
+
+static BenchPhase current_phase(const GameState& state) {
+    if (state.phase == PHASE_TITLE || !state.game_instance) return BENCH_TITLE;
+    switch (state.game_instance->gameplay_phase()) {
+        case GAMEPLAY_COUNTDOWN: return BENCH_COUNTDOWN;
+        case GAMEPLAY_PLAYING: return BENCH_PLAYING;
+        case GAMEPLAY_GAMEOVER: break;
+    }
+    return BENCH_GAMEOVER;
+}
+
+static GameState s_state;
+
+int main() {
+    uart_init();
+    cycle_counter_init();
+
+    // Cost of reading the counter itself, subtracted from every sample
+    uint32_t t0 = read_cycles();
+    uint32_t t1 = read_cycles();
+    uint32_t overhead = t1 - t0;
+
+    printf("# avr_bench atmega328p %lu Hz, frame budget %lu cycles\n",
+           (unsigned long)F_CPU, (unsigned long)FRAME_BUDGET_CYCLES);
+    printf("# sizeof(GameState) = %u\n", (unsigned)sizeof(GameState));
+    printf("game phase frames min avg max budget%%\n");
+
+    for (int game = 0; game < NUM_GAMES; ++game) {
+        PhaseStats stats[NUM_BENCH_PHASES] = {};
+        game_srand(1 + game);
+        set_initial_game(s_state);
+
+        InputScript script;
+        input_script_init(script, game, 1 + game);
+        for (int i = 0; i < BENCH_FRAMES_PER_GAME; ++i) {
+            bool button = input_script_next(script);
+            BenchPhase phase = current_phase(s_state);
+            uint32_t start = read_cycles();
+            update_game(s_state, button);
+            uint32_t cycles = read_cycles() - start - overhead;
+            add_sample(stats[phase], cycles);
+        }
+        delete s_state.game_instance;
+        s_state.game_instance = NULL;
+
+        for (int p = 0; p < NUM_BENCH_PHASES; ++p) {
+            if (stats[p].count == 0) continue;
+            printf("%s %s %u %lu %lu %lu %lu\n", GAME_NAMES[game], PHASE_NAMES[p], stats[p].count,
+                   (unsigned long)stats[p].min, (unsigned long)(stats[p].sum / stats[p].count),
+                   (unsigned long)stats[p].max,
+                   (unsigned long)(stats[p].max * 100 / FRAME_BUDGET_CYCLES));
+        }
+    }
+
+    // simavr exits when the CPU sleeps with interrupts disabled
+    cli();
+    sleep_enable();
+    sleep_cpu();
+    return 0;
+}
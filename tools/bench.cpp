@@ -0,0 +1,264 @@
+// Microbenchmarks for the core drawing and update paths.
+//
+// Every measurement is printed as one JSON document on stdout, so runs of
+// different builds can be diffed or collected by a script:
+//
+//   ./build/bench > native.json        (native, see build_native.sh)
+//   node build/bench.js > wasm.json    (WASM, see "sh build.sh bench")
+//
+// Game updates are measured per phase by restoring a snapshot of the state
+// before every call; the cost of the restore itself is measured separately
+// and subtracted.
+
+#include "game_logic.h"
+#include "game_bot.h"
+#include "entity_pool.h"
+#include "framebuffer_kernels.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+static inline uint64_t read_cycles() { return __rdtsc(); }
+#else
+#define BENCH_HAS_CYCLES 0
+static inline uint64_t read_cycles() { return 0; }
+#endif
+
+// --- Bench Constants ---
+const int BENCH_ITERATIONS = 20000;
+const int BENCH_REPEATS = 5; // The fastest repeat is reported
+const int MAX_PHASE_SETUP_FRAMES = 20000;
+const char* GAME_NAMES[NUM_GAMES] = {"jump", "chase", "fill", "brightness"};
+const int COUNTDOWN_FRAMES[NUM_GAMES] = {120, 0, 0, 0}; // Only JumpGame starts with a countdown
+
+// --- Measurement ---
+struct Sample {
+    double ns;
+    double cycles;
+};
+
+typedef void (*BenchFn)(void* ctx);
+
+static Sample measure(BenchFn fn, void* ctx) {
+    Sample best = {1e30, 1e30};
+    for (int rep = 0; rep < BENCH_REPEATS; ++rep) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = read_cycles();
+        for (int i = 0; i < BENCH_ITERATIONS; ++i) fn(ctx);
+        uint64_t c1 = read_cycles();
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / BENCH_ITERATIONS;
+        double cycles = (double)(c1 - c0) / BENCH_ITERATIONS;
+        if (ns < best.ns) best.ns = ns;
+        if (cycles < best.cycles) best.cycles = cycles;
+    }
+    return best;
+}
+
+static bool s_first_result = true;
+
+static void report(const char* name, const char* phase, Sample sample) {
+    printf("%s\n    {\"name\": \"%s\"", s_first_result ? "" : ",", name);
+    if (phase) printf(", \"phase\": \"%s\"", phase);
+    printf(", \"ns_per_op\": %.2f", sample.ns);
+    if (BENCH_HAS_CYCLES) printf(", \"cycles_per_op\": %.1f}", sample.cycles);
+    else printf(", \"cycles_per_op\": null}");
+    s_first_result = false;
+}
+
+// --- Drawing Benchmarks ---
+static GameState s_state;
+
+static void bench_clear_screen(void*) { clear_screen(s_state); }
+static void bench_draw_char(void*) { draw_char(s_state, 'A', 5, 5, 7); }
+static void bench_draw_text(void*) { draw_text(s_state, "GAME", 1, 2, 1); }
+static void bench_draw_score(void*) { draw_score(s_state, SCREEN_WIDTH / 2, 10, 7); }
+#ifdef __EMSCRIPTEN__
+static void bench_render_screen(void*) { render_screen(s_state); }
+#endif
+
+// --- Framebuffer Kernel Benchmarks ---
+// Each op covers the whole screen (16 rows), once with the build's SIMD backend
+// and once with the scalar reference, so the two can be compared in one run.
+static uint8_t s_other[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint16_t s_row_masks[SCREEN_HEIGHT];
+static const uint8_t BENCH_PALETTE[16] = {0, 224, 28, 252, 3, 227, 31, 255, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static void init_kernel_inputs() {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) {
+        s_row_masks[y] = (uint16_t)(0x9249u << (y % 3)); // Every third cell, like sparse walls
+        for (int x = 0; x < SCREEN_WIDTH; ++x) s_other[y][x] = (uint8_t)((x * 7 + y * 3) & 7);
+    }
+}
+
+static void bench_fb_fill_row_mask(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_fill_row_mask(s_state.screen[y], s_row_masks[y], 7);
+}
+static void bench_fb_fill_row_mask_scalar(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_scalar_fill_row_mask(s_state.screen[y], s_row_masks[y], 7);
+}
+static void bench_fb_diff_row(void*) {
+    uint16_t any = 0;
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) any |= fb_diff_row(s_state.screen[y], s_other[y]);
+    s_state.frame_count = any; // Keep the result alive
+}
+static void bench_fb_diff_row_scalar(void*) {
+    uint16_t any = 0;
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) any |= fb_scalar_diff_row(s_state.screen[y], s_other[y]);
+    s_state.frame_count = any;
+}
+static void bench_fb_palette_row(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_palette_row(s_other[y], BENCH_PALETTE, s_state.screen[y]);
+}
+static void bench_fb_palette_row_scalar(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_scalar_palette_row(s_other[y], BENCH_PALETTE, s_state.screen[y]);
+}
+static void bench_fb_blit_row(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_blit_row(s_state.screen[y], s_other[y], 0);
+}
+static void bench_fb_blit_row_scalar(void*) {
+    for (int y = 0; y < SCREEN_HEIGHT; ++y) fb_scalar_blit_row(s_state.screen[y], s_other[y], 0);
+}
+
+// --- Entity Pool Benchmarks ---
+// A full pool of particles bursting from the centre, as an explosion effect would
+const int BENCH_PARTICLES = 250;
+static EntityPool<BENCH_PARTICLES> s_particles;
+static uint32_t s_particle_rng = 1;
+
+static void refill_particles() {
+    while (!s_particles.full()) {
+        s_particle_rng = s_particle_rng * 1664525u + 1013904223u;
+        EntityFixed vx = (EntityFixed)((int)(s_particle_rng >> 24) - 128);
+        EntityFixed vy = (EntityFixed)((int)((s_particle_rng >> 16) & 0xFF) - 128);
+        s_particles.spawn(entity_fixed(SCREEN_WIDTH / 2), entity_fixed(SCREEN_HEIGHT / 2), vx, vy,
+                          (uint8_t)(8 + (s_particle_rng & 31)), (uint8_t)(1 + (s_particle_rng >> 8) % 7));
+    }
+}
+
+static void bench_particles_frame(void*) {
+    refill_particles();
+    s_particles.integrate();
+    s_particles.cull(0);
+    s_particles.draw(s_state);
+}
+
+// --- Game Benchmarks ---
+struct PhaseSnapshot {
+    GameState state;
+    IGame* game;
+    GameInstanceStorage storage;  // Holds the snapshot's game
+    GameInstanceStorage scratch;  // Restored copy that update() runs on
+    GameState scratch_state;
+};
+
+static void restore(PhaseSnapshot& snap) {
+    snap.scratch_state = snap.state;
+    snap.scratch_state.game_instance = snap.game->clone_into(snap.scratch.bytes);
+}
+
+static void bench_restore(void* ctx) {
+    PhaseSnapshot& snap = *(PhaseSnapshot*)ctx;
+    restore(snap);
+    snap.scratch_state.game_instance->~IGame();
+}
+
+static void bench_restore_update(void* ctx) {
+    PhaseSnapshot& snap = *(PhaseSnapshot*)ctx;
+    restore(snap);
+    snap.scratch_state.game_instance->update(snap.scratch_state, false);
+    snap.scratch_state.game_instance->~IGame();
+}
+
+static void bench_draw_title(void* ctx) {
+    GameState& state = *(GameState*)ctx;
+    draw_game_title(state, state.current_selection);
+}
+
+static void take_snapshot(PhaseSnapshot& snap, const GameState& state) {
+    snap.state = state;
+    snap.game = state.game_instance->clone_into(snap.storage.bytes);
+    snap.state.game_instance = snap.game;
+}
+
+static void bench_phase(const char* name, const char* phase, const GameState& state) {
+    static PhaseSnapshot snap;
+    take_snapshot(snap, state);
+    Sample total = measure(bench_restore_update, &snap);
+    Sample overhead = measure(bench_restore, &snap);
+    Sample sample = {total.ns - overhead.ns, total.cycles - overhead.cycles};
+    report(name, phase, sample);
+    snap.game->~IGame();
+}
+
+static void bench_game(int game) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s.draw_title", GAME_NAMES[game]);
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    game_srand(1);
+    state.current_brightness = 16;
+    state.text_scroll_offset = SCREEN_WIDTH;
+    state.current_selection = (GameSelection)game;
+    report(name, "title", measure(bench_draw_title, &state));
+    state.game_instance = create_game_instance((GameSelection)game, state);
+
+    snprintf(name, sizeof(name), "%s.update", GAME_NAMES[game]);
+    if (COUNTDOWN_FRAMES[game] > 0) {
+        bench_phase(name, "countdown", state);
+        for (int i = 0; i < COUNTDOWN_FRAMES[game]; ++i) state.game_instance->update(state, false);
+    }
+    bench_phase(name, "playing", state);
+
+    // Idle until the game ends on its own (BrightnessGame never does)
+    for (int i = 0; i < MAX_PHASE_SETUP_FRAMES && !state.game_instance->is_game_over(); ++i) {
+        state.game_instance->update(state, false);
+        state.was_button_pressed_last_frame = false;
+    }
+    if (state.game_instance->is_game_over()) {
+        bench_phase(name, "gameover", state);
+    }
+    delete state.game_instance;
+}
+
+int main() {
+    memset(&s_state, 0, sizeof(s_state));
+    s_state.score = 123;
+
+    printf("{\n  \"platform\": \"%s\",\n  \"simd\": \"%s\",\n  \"iterations\": %d,\n  \"results\": [",
+#ifdef __EMSCRIPTEN__
+           "wasm",
+#else
+           "native",
+#endif
+           FB_KERNELS_BACKEND, BENCH_ITERATIONS);
+
+    report("clear_screen", NULL, measure(bench_clear_screen, NULL));
+    report("draw_char", NULL, measure(bench_draw_char, NULL));
+    report("draw_text", NULL, measure(bench_draw_text, NULL));
+    report("draw_score", NULL, measure(bench_draw_score, NULL));
+#ifdef __EMSCRIPTEN__
+    report("render_screen", NULL, measure(bench_render_screen, NULL));
+#endif
+    init_kernel_inputs();
+    report("fb.fill_row_mask", NULL, measure(bench_fb_fill_row_mask, NULL));
+    report("fb.fill_row_mask.scalar", NULL, measure(bench_fb_fill_row_mask_scalar, NULL));
+    report("fb.diff_row", NULL, measure(bench_fb_diff_row, NULL));
+    report("fb.diff_row.scalar", NULL, measure(bench_fb_diff_row_scalar, NULL));
+    report("fb.palette_row", NULL, measure(bench_fb_palette_row, NULL));
+    report("fb.palette_row.scalar", NULL, measure(bench_fb_palette_row_scalar, NULL));
+    report("fb.blit_row", NULL, measure(bench_fb_blit_row, NULL));
+    report("fb.blit_row.scalar", NULL, measure(bench_fb_blit_row_scalar, NULL));
+    s_particles.clear();
+    report("entity_pool.frame_250", NULL, measure(bench_particles_frame, NULL));
+    for (int game = 0; game < NUM_GAMES; ++game) {
+        bench_game(game);
+    }
+
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Fuzz target for the core loop: arbitrary seeds and button sequences through
+// set_initial_game()/update_game(), across all four games.
+//
+// Input layout:
+//   bytes 0-3  game_srand() seed (little-endian)
+//   byte  4    bits 0-1: game selected before the first frame
+//              bit 2: assisted, the bot plays while a game is running
+//              (assisted target only)
+//   rest       button runs, one per byte: bit 0 is the button, bits 1-7 + 1
+//              the number of frames it is held (1-128)
+// Run-length input lets a few bytes reach long presses, game over and the
+// attract-mode bot. Random taps rarely survive long, so the assisted target
+// (--assisted, or -DPOCHI_FUZZ_ASSISTED for libFuzzer) lets the bot play
+// inputs with bit 2 set (the runs still drive the title and game-over screens)
+// to reach high scores, later levels and line clears. The bot simulates
+// hundreds of frames per real frame, so it is a separate target with its own
+// corpus, and the plain target ignores bit 2 and stays fast.
+// Every frame the screen must hold only palette colours and
+// the phase and selection must stay valid; out-of-bounds writes are left to
+// ASan/UBSan (-fsanitize=bounds catches screen[y][x] with y or x off-screen,
+// which ASan alone would not, since it stays inside GameState).
+//
+// libFuzzer (coverage-guided, clang):
+//   clang++ -std=c++11 -g -O1 -fsanitize=fuzzer,address,undefined -DPOCHI_LIBFUZZER
+//           -Isrc $CORE tools/fuzz_update.cpp -o build/fuzz_update
+//   ./build/fuzz_update -jobs=$(nproc) -workers=$(nproc) corpus/
+//   (add -DPOCHI_FUZZ_ASSISTED, -o build/fuzz_update_assisted and corpus-assisted/
+//   for the assisted target)
+//
+// Standalone (any g++, built by build_native.sh): random and mutated inputs,
+// one forked worker per core, no coverage feedback.
+//   ./build/fuzz_update [--assisted] [--jobs N] [--seconds S] [--runs R] [--seed S]
+//   ./build/fuzz_update [--assisted] FILE...     run saved inputs once (reproduce a crash)
+// A worker that fails leaves the input in fuzz-worker-<N>.bin.
+
+#include "game_logic.h"
+#include "game_bot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Fuzz Constants ---
+const size_t FUZZ_HEADER_SIZE = 5;
+const int FUZZ_MAX_FRAMES = 3600;   // Caps one input at ~1 min of play; random taps lose well before
+const int FUZZ_MAX_ASSISTED_FRAMES = 20000; // ~5.5 min, so the bot reaches the later levels
+const int NUM_PALETTE_COLORS = 8;   // Web palette and frame stream carry 3 bits
+const size_t FUZZ_MAX_INPUT = 512;
+const uint8_t FUZZ_FLAG_ASSISTED = 0x04;
+const int FUZZ_ASSIST_BUDGET = BOT_DEFAULT_SEARCH_BUDGET; // Smaller budgets play too badly to help
+
+static void fuzz_fail(const char* what, int frame) {
+    fprintf(stderr, "fuzz_update: %s at frame %d\n", what, frame);
+    abort();
+}
+
+static long s_frames_run; // For the standalone driver's report
+
+#ifdef POCHI_FUZZ_ASSISTED
+static bool s_assisted_target = true;
+#else
+static bool s_assisted_target = false; // Set by --assisted in the standalone driver
+#endif
+
+static void check_invariants(const GameState& state, int frame) {
+    for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+        for (int c = 0; c < SCREEN_WIDTH; ++c) {
+            if (state.screen[r][c] >= NUM_PALETTE_COLORS) fuzz_fail("colour outside the palette", frame);
+        }
+    }
+    if ((unsigned)state.current_selection >= NUM_GAMES) fuzz_fail("invalid selection", frame);
+    if (state.phase != PHASE_TITLE && !state.game_instance) fuzz_fail("playing without a game instance", frame);
+    if (state.score < 0) fuzz_fail("negative score", frame);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < FUZZ_HEADER_SIZE) return 0;
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    game_srand(data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24));
+    set_initial_game(state);
+    state.current_selection = (GameSelection)(data[4] % NUM_GAMES); // The title owns no instance yet
+    bool assisted = s_assisted_target && (data[4] & FUZZ_FLAG_ASSISTED);
+
+    int max_frames = assisted ? FUZZ_MAX_ASSISTED_FRAMES : FUZZ_MAX_FRAMES;
+    int frame = 0;
+    for (size_t i = FUZZ_HEADER_SIZE; i < size && frame < max_frames; ++i) {
+        bool pressed = data[i] & 1;
+        int run = (data[i] >> 1) + 1;
+        for (int k = 0; k < run && frame < max_frames; ++k, ++frame) {
+            bool button = pressed;
+            if (assisted && state.phase != PHASE_TITLE && !state.demo_mode &&
+                !state.game_instance->is_game_over()) {
+                button = bot_choose_input(state, FUZZ_ASSIST_BUDGET);
+            }
+            update_game(state, button);
+            check_invariants(state, frame);
+        }
+    }
+    s_frames_run += frame;
+    delete state.game_instance;
+    return 0;
+}
+
+#ifndef POCHI_LIBFUZZER
+// --- Standalone Driver ---
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+static uint8_t s_input[FUZZ_MAX_INPUT];
+static size_t s_input_size;
+
+// Each worker writes the input it is about to run here. A sanitizer report
+// ends the process without unwinding, so the file is left holding the input
+// that failed; clean workers delete theirs.
+static void worker_input_path(char* path, size_t size, int worker) {
+    snprintf(path, size, "fuzz-worker-%d.bin", worker);
+}
+
+static void save_input(const char* path) {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return;
+    fwrite(s_input, 1, s_input_size, fp);
+    fclose(fp);
+}
+
+static uint32_t s_rng;
+static uint32_t fuzz_rand() {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// Fresh random input, or a mutation of the last one that ran clean
+static void next_input() {
+    if (s_input_size < FUZZ_HEADER_SIZE || fuzz_rand() % 4 == 0) {
+        s_input_size = FUZZ_HEADER_SIZE + fuzz_rand() % (FUZZ_MAX_INPUT - FUZZ_HEADER_SIZE);
+        for (size_t i = 0; i < s_input_size; ++i) s_input[i] = (uint8_t)fuzz_rand();
+        return;
+    }
+    int mutations = 1 + fuzz_rand() % 8;
+    for (int m = 0; m < mutations; ++m) {
+        size_t at = fuzz_rand() % s_input_size;
+        switch (fuzz_rand() % 4) {
+            case 0: s_input[at] = (uint8_t)fuzz_rand(); break;
+            case 1: s_input[at] ^= (uint8_t)(1 << (fuzz_rand() % 8)); break;
+            case 2: // Grow or shrink at the end
+                if (s_input_size < FUZZ_MAX_INPUT && fuzz_rand() & 1) s_input[s_input_size++] = (uint8_t)fuzz_rand();
+                else if (s_input_size > FUZZ_HEADER_SIZE) s_input_size--;
+                break;
+            case 3: // Repeat a byte, e.g. a long hold
+                if (at + 1 < s_input_size) s_input[at + 1] = s_input[at];
+                break;
+        }
+    }
+}
+
+static int run_worker(int worker, uint32_t seed, long max_runs, time_t deadline) {
+    char path[64];
+    worker_input_path(path, sizeof(path), worker);
+    s_rng = seed ? seed : 1;
+
+    long run = 0;
+    for (; (max_runs < 0 || run < max_runs) && time(NULL) < deadline; ++run) {
+        next_input();
+        save_input(path); // Small next to running the input
+        LLVMFuzzerTestOneInput(s_input, s_input_size);
+    }
+    remove(path);
+    printf("worker %d: %ld runs, %ld frames\n", worker, run, s_frames_run);
+    fflush(stdout); // The worker leaves through _exit()
+    return 0;
+}
+
+static int run_files(int argc, char** argv, int first) {
+    for (int i = first; i < argc; ++i) {
+        FILE* fp = fopen(argv[i], "rb");
+        if (!fp) {
+            fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 2;
+        }
+        s_input_size = fread(s_input, 1, FUZZ_MAX_INPUT, fp);
+        fclose(fp);
+        LLVMFuzzerTestOneInput(s_input, s_input_size);
+        printf("%s ok\n", argv[i]);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    long seconds = 60;
+    long runs = -1;
+    uint32_t seed = (uint32_t)time(NULL);
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; ++i) {
+        if (!strcmp(argv[i], "--assisted")) {
+            s_assisted_target = true;
+        } else if (!strcmp(argv[i], "--jobs") && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--assisted] [--jobs N] [--seconds S] [--runs R] [--seed S] | FILE...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (i < argc) return run_files(argc, argv, i);
+    if (jobs < 1) jobs = 1;
+
+    printf("fuzzing %s with %d workers for %ld s, seed %u\n", s_assisted_target ? "assisted" : "plain", jobs,
+           seconds, seed);
+    fflush(stdout);
+    time_t deadline = time(NULL) + seconds;
+    pid_t* pids = new pid_t[jobs];
+    for (int w = 0; w < jobs; ++w) {
+        pid_t pid = fork();
+        if (pid == 0) _exit(run_worker(w, seed + w * 0x9E3779B9u, runs, deadline));
+        pids[w] = pid;
+        if (pid < 0) {
+            perror("fork");
+            return 2;
+        }
+    }
+
+    int failed = 0;
+    for (int w = 0; w < jobs; ++w) {
+        int status = 0;
+        if (waitpid(pids[w], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            char path[64];
+            worker_input_path(path, sizeof(path), w);
+            printf("worker %d failed, input left in %s\n", w, path);
+            failed++;
+        }
+    }
+    printf("%d of %d workers found a failure\n", failed, jobs);
+    delete[] pids;
+    return failed ? 1 : 0;
+}
+#endif // POCHI_LIBFUZZER
@@ -0,0 +1,179 @@
+// Native harness for the simulation/output triple buffer (src/frame_handoff.h).
+//
+// A producer thread publishes frames, and a consumer thread acquires them and
+// optionally spends a fixed time "showing" each one. Every published frame's
+// hash is recorded before publishing, and the consumer checks that the screen
+// it received hashes to the same value, so a torn or mixed-up frame is
+// reported. It also prints handoff latency (publish to acquire) and how
+// late the producer's ticks were.
+//
+//   handoff_test                         free-running stress with a synthetic pattern
+//   handoff_test --game N --tick-us 16667 --show-us 7680
+//                                        the real game at ~60 Hz with a WS2812-like show()
+//
+// Exit status is 1 if any frame was torn or arrived out of order.
+
+#include "game_logic.h"
+#include "frame_handoff.h"
+#include "input_script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// --- Harness Constants ---
+const int DEFAULT_STRESS_FRAMES = 200000;
+const int DEFAULT_PACED_FRAMES = 600;
+
+typedef std::chrono::steady_clock Clock;
+static Clock::time_point s_start;
+
+static uint32_t now_us() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - s_start).count();
+}
+
+static void busy_wait_us(uint32_t us) {
+    uint32_t until = now_us() + us;
+    while ((int32_t)(now_us() - until) < 0) {}
+}
+
+// --- Shared Between Threads ---
+static FrameHandoff s_handoff;
+static std::vector<uint64_t> s_published_hashes; // Written before the frame is published
+static std::atomic<bool> s_producer_done(false);
+
+struct ProducerResult {
+    uint32_t max_late_us; // Worst tick lateness (paced mode only)
+};
+
+struct ConsumerResult {
+    uint32_t presented;
+    uint32_t torn;
+    uint32_t out_of_order;
+    std::vector<uint32_t> latencies_us;
+};
+
+// Synthetic frame: every pixel depends on the frame number and its position,
+// so any mix of two frames changes the hash.
+static void fill_pattern(GameState& state, uint32_t frame) {
+    for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+        for (int c = 0; c < SCREEN_WIDTH; ++c) {
+            state.screen[r][c] = (uint8_t)(frame * 31 + r * SCREEN_WIDTH + c);
+        }
+    }
+}
+
+static void producer(int game, int frames, uint32_t tick_us, ProducerResult* result) {
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    InputScript script;
+    input_script_init(script, game, 1 + game);
+    if (game >= 0) {
+        game_srand(1 + game);
+        set_initial_game(state);
+    }
+
+    result->max_late_us = 0;
+    uint32_t next_tick = now_us();
+    for (int frame = 0; frame < frames; ++frame) {
+        if (tick_us) {
+            // Strict tick: sleep until the deadline, then note how late we woke up
+            while ((int32_t)(next_tick - now_us()) > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(next_tick - now_us()));
+            }
+            uint32_t late = now_us() - next_tick;
+            if (late > result->max_late_us) result->max_late_us = late;
+            next_tick += tick_us;
+        }
+
+        if (game >= 0) update_game(state, input_script_next(script));
+        else fill_pattern(state, frame);
+
+        s_published_hashes[frame] = hash_screen(state);
+        frame_handoff_publish_state(s_handoff, state, frame, now_us());
+    }
+    if (game >= 0) delete state.game_instance;
+    s_producer_done.store(true, std::memory_order_release);
+}
+
+static void consumer(uint32_t show_us, ConsumerResult* result) {
+    GameState check;
+    int64_t last_frame = -1;
+    result->presented = result->torn = result->out_of_order = 0;
+    for (;;) {
+        bool done = s_producer_done.load(std::memory_order_acquire);
+        if (!frame_handoff_acquire(s_handoff)) {
+            if (done) break; // Nothing left: the last frame has been consumed
+            continue;
+        }
+        const HandoffFrame& slot = frame_handoff_front(s_handoff);
+        result->latencies_us.push_back(now_us() - slot.published_us);
+
+        memcpy(check.screen, slot.screen, sizeof(check.screen));
+        if (hash_screen(check) != s_published_hashes[slot.frame]) result->torn++;
+        if ((int64_t)slot.frame <= last_frame) result->out_of_order++;
+        last_frame = slot.frame;
+        result->presented++;
+
+        if (show_us) busy_wait_us(show_us); // Stands in for matrix.show()
+    }
+}
+
+static uint32_t percentile(std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    int game = -1;
+    int frames = -1;
+    uint32_t tick_us = 0;
+    uint32_t show_us = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--game") && i + 1 < argc) {
+            game = atoi(argv[++i]) % NUM_GAMES;
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--tick-us") && i + 1 < argc) {
+            tick_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--show-us") && i + 1 < argc) {
+            show_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--game N] [--frames F] [--tick-us T] [--show-us S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 0) frames = tick_us ? DEFAULT_PACED_FRAMES : DEFAULT_STRESS_FRAMES;
+
+    s_start = Clock::now();
+    s_published_hashes.assign(frames, 0);
+    frame_handoff_init(s_handoff);
+
+    ProducerResult produced;
+    ConsumerResult consumed;
+    std::thread output_thread(consumer, show_us, &consumed);
+    std::thread sim_thread(producer, game, frames, tick_us, &produced);
+    sim_thread.join();
+    output_thread.join();
+
+    std::vector<uint32_t>& lat = consumed.latencies_us;
+    std::sort(lat.begin(), lat.end());
+    uint64_t lat_sum = 0;
+    for (size_t i = 0; i < lat.size(); ++i) lat_sum += lat[i];
+
+    printf("frames published %d, presented %u, skipped %u\n", frames, consumed.presented,
+           frames - consumed.presented);
+    printf("torn %u, out of order %u\n", consumed.torn, consumed.out_of_order);
+    printf("handoff latency us: min %u, avg %.1f, p50 %u, p99 %u, max %u\n",
+           percentile(lat, 0.0), lat.empty() ? 0.0 : (double)lat_sum / lat.size(),
+           percentile(lat, 0.5), percentile(lat, 0.99), percentile(lat, 1.0));
+    if (tick_us) printf("producer tick %u us, worst lateness %u us\n", tick_us, produced.max_late_us);
+
+    return (consumed.torn || consumed.out_of_order) ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <stdint.h>
+
+// --- Scripted Input ---
+// Deterministic button sequence shared by the native tools and the AVR bench.
+// It selects the game with long presses, starts it with a short press and then
+// plays random taps. It uses its own generator so it never disturbs game_rand().
+
+#define INPUT_SCRIPT_SELECT_HOLD_FRAMES 22 // Longer than LONG_PRESS_FRAMES in game_logic.cpp
+
+struct InputScript {
+    int game;
+    uint32_t rng;
+    long frame;
+    int run_left;
+    bool run_pressed;
+};
+
+static inline void input_script_init(InputScript& script, int game, uint32_t seed) {
+    script.game = game;
+    script.rng = seed;
+    script.frame = 0;
+    script.run_left = 0;
+    script.run_pressed = false;
+}
+
+static inline uint32_t input_script_random(InputScript& script) {
+    script.rng = script.rng * 1664525u + 1013904223u;
+    return script.rng >> 8;
+}
+
+// Returns the button state for the next frame.
+static inline bool input_script_next(InputScript& script) {
+    const int SELECT_PERIOD = INPUT_SCRIPT_SELECT_HOLD_FRAMES + 2;
+    long f = script.frame++;
+    long select_frames = (long)script.game * SELECT_PERIOD;
+    if (f < 2) return false; // Let set_initial_game's input lock release
+    f -= 2;
+    if (f < select_frames) return (f % SELECT_PERIOD) < INPUT_SCRIPT_SELECT_HOLD_FRAMES;
+    f -= select_frames;
+    if (f < 2) return f == 0; // Short press starts the game
+    if (script.run_left == 0) {
+        script.run_pressed = !script.run_pressed;
+        script.run_left = script.run_pressed ? 1 + input_script_random(script) % 3
+                                             : 1 + input_script_random(script) % 40;
+    }
+    script.run_left--;
+    return script.run_pressed;
+}
+
+#endif // INPUT_SCRIPT_H
@@ -0,0 +1,316 @@
+// Records, inspects, seeks and exports session recordings (see src/replay.h).
+//
+//   replay_tool record OUT [--game N] [--seed S] [--frames F] [--video]
+//   replay_tool info FILE
+//   replay_tool seek FILE FRAME                 print the screen hash of FRAME
+//   replay_tool png FILE FROM COUNT OUT.png [--step K] [--scale S]
+//
+// "record" plays the scripted input of tools/input_script.h, so
+// "replay_tool seek" can be compared with "runner --game N --seed S".
+
+#include "game_logic.h"
+#include "replay.h"
+#include "input_script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <vector>
+
+// --- Loading ---
+struct Keyframe {
+    uint32_t frame;
+    size_t snapshot_offset;   // Offset of the snapshot in the file data
+};
+
+struct Recording {
+    std::vector<uint8_t> data;
+    uint16_t keyframe_interval;
+    uint8_t flags;
+    std::vector<Keyframe> keyframes;
+    std::vector<uint8_t> inputs;       // One byte per frame, unpacked
+    size_t input_bytes;
+    size_t snapshot_bytes;
+    size_t video_bytes;
+};
+
+static bool load_recording(const char* path, Recording& rec) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) rec.data.insert(rec.data.end(), buf, buf + n);
+    fclose(fp);
+
+    const std::vector<uint8_t>& d = rec.data;
+    if (d.size() < REPLAY_HEADER_SIZE || memcmp(&d[0], "PPRP", 4) != 0 || d[4] != REPLAY_VERSION) {
+        fprintf(stderr, "%s: not a replay file\n", path);
+        return false;
+    }
+    if ((d[5] | (d[6] << 8)) != sizeof(GameState)) {
+        fprintf(stderr, "%s: recorded by a different build (GameState size differs)\n", path);
+        return false;
+    }
+    rec.keyframe_interval = d[7] | (d[8] << 8);
+    rec.flags = d[9];
+    rec.input_bytes = rec.snapshot_bytes = rec.video_bytes = 0;
+
+    size_t pos = REPLAY_HEADER_SIZE;
+    while (pos < d.size()) {
+        uint8_t tag = d[pos];
+        if (tag == 'K' && pos + 11 <= d.size()) {
+            Keyframe key;
+            key.frame = d[pos + 1] | (d[pos + 2] << 8) | (d[pos + 3] << 16) | ((uint32_t)d[pos + 4] << 24);
+            key.snapshot_offset = pos + 5;
+            int size = replay_snapshot_size((GameSelection)d[pos + 9], d[pos + 10] != 0);
+            rec.keyframes.push_back(key);
+            rec.snapshot_bytes += 5 + size;
+            pos += 5 + size;
+        } else if (tag == 'I' && pos + 3 <= d.size()) {
+            int count = d[pos + 1] | (d[pos + 2] << 8);
+            for (int i = 0; i < count; ++i) rec.inputs.push_back((d[pos + 3 + i / 8] >> (i % 8)) & 1);
+            rec.input_bytes += 3 + (count + 7) / 8;
+            pos += 3 + (count + 7) / 8;
+        } else if (tag == 'D' && pos + 1 + FRAME_STREAM_HEADER_SIZE <= d.size()) {
+            int size = FRAME_STREAM_HEADER_SIZE + d[pos + 1 + 3] + 1;
+            rec.video_bytes += 1 + size;
+            pos += 1 + size;
+        } else {
+            fprintf(stderr, "%s: corrupt chunk at offset %zu\n", path, pos);
+            return false;
+        }
+    }
+    if (pos > d.size()) {
+        fprintf(stderr, "%s: truncated\n", path);
+        return false;
+    }
+    return true;
+}
+
+// --- Seeking ---
+// Restores the nearest keyframe at or before `frame` and simulates up to it.
+// O(keyframe interval) frames of work.
+static bool seek(const Recording& rec, uint32_t frame, GameState& state) {
+    if (frame >= rec.inputs.size()) return false;
+    const Keyframe* key = NULL;
+    for (size_t i = 0; i < rec.keyframes.size() && rec.keyframes[i].frame <= frame; ++i) key = &rec.keyframes[i];
+    if (!key) return false;
+
+    const uint8_t* snapshot = &rec.data[key->snapshot_offset];
+    if (replay_read_snapshot(state, snapshot, (int)(rec.data.size() - key->snapshot_offset)) < 0) return false;
+    for (uint32_t f = key->frame; f <= frame; ++f) {
+        update_game(state, rec.inputs[f] != 0);
+    }
+    return true;
+}
+
+// --- PNG Export ---
+// Uncompressed (stored deflate blocks) PNG; strips are tiny, so no zlib needed.
+static const uint8_t PALETTE_RGB[8][3] = {
+    {0, 0, 0}, {255, 0, 0}, {0, 255, 0}, {255, 255, 0},
+    {0, 0, 255}, {255, 0, 255}, {0, 255, 255}, {255, 255, 255},
+};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void put_be32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 3; i >= 0; --i) out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+static void write_png_chunk(FILE* fp, const char* type, const std::vector<uint8_t>& body) {
+    std::vector<uint8_t> chunk;
+    put_be32(chunk, body.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), body.begin(), body.end());
+    uint32_t crc = crc32_update(0, &chunk[4], chunk.size() - 4);
+    put_be32(chunk, crc);
+    fwrite(&chunk[0], 1, chunk.size(), fp);
+}
+
+static bool write_png(const char* path, const std::vector<uint8_t>& indices, int width, int height) {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(SIGNATURE, 1, sizeof(SIGNATURE), fp);
+
+    std::vector<uint8_t> ihdr;
+    put_be32(ihdr, width);
+    put_be32(ihdr, height);
+    const uint8_t rest[5] = {8, 3, 0, 0, 0}; // 8-bit palette image
+    ihdr.insert(ihdr.end(), rest, rest + 5);
+    write_png_chunk(fp, "IHDR", ihdr);
+
+    std::vector<uint8_t> plte(&PALETTE_RGB[0][0], &PALETTE_RGB[0][0] + sizeof(PALETTE_RGB));
+    write_png_chunk(fp, "PLTE", plte);
+
+    // Raw scanlines (filter byte 0) wrapped in a zlib stream of stored blocks
+    std::vector<uint8_t> raw;
+    for (int y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), indices.begin() + (size_t)y * width, indices.begin() + (size_t)(y + 1) * width);
+    }
+    std::vector<uint8_t> idat;
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); ++i) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        size_t len = raw.size() - pos > 65535 ? 65535 : raw.size() - pos;
+        idat.push_back(pos + len == raw.size() ? 1 : 0);
+        idat.push_back(len & 0xFF);
+        idat.push_back(len >> 8);
+        idat.push_back(~len & 0xFF);
+        idat.push_back((~len >> 8) & 0xFF);
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+        if (len == 0) break;
+    }
+    put_be32(idat, (b << 16) | a);
+    write_png_chunk(fp, "IDAT", idat);
+    write_png_chunk(fp, "IEND", std::vector<uint8_t>());
+    fclose(fp);
+    return true;
+}
+
+// --- Commands ---
+
+static void write_to_file(const uint8_t* data, int len, void* ctx) {
+    fwrite(data, 1, len, (FILE*)ctx);
+}
+
+static int cmd_record(int argc, char** argv) {
+    int game = GAME_JUMP;
+    uint32_t seed = 1;
+    int frames = 3600;
+    uint8_t flags = 0;
+    for (int i = 3; i < argc; ++i) {
+        if (!strcmp(argv[i], "--game") && i + 1 < argc) game = atoi(argv[++i]) % NUM_GAMES;
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--video")) flags |= REPLAY_FLAG_VIDEO;
+    }
+
+    FILE* fp = fopen(argv[2], "wb");
+    if (!fp) {
+        perror(argv[2]);
+        return 1;
+    }
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    game_srand(seed);
+    set_initial_game(state);
+
+    static ReplayRecorder recorder;
+    replay_record_begin(recorder, write_to_file, fp, REPLAY_DEFAULT_KEYFRAME_INTERVAL, flags);
+    InputScript script;
+    input_script_init(script, game, seed);
+    for (int i = 0; i < frames; ++i) {
+        bool button = input_script_next(script);
+        replay_record_input(recorder, state, button);
+        update_game(state, button);
+        replay_record_video(recorder, state);
+    }
+    replay_record_end(recorder);
+    fclose(fp);
+    delete state.game_instance;
+    return 0;
+}
+
+static int cmd_info(const Recording& rec) {
+    size_t frames = rec.inputs.size();
+    double minutes = frames / 60.0 / 60.0;
+    printf("frames            %zu (%.2f min at 60 fps)\n", frames, minutes);
+    printf("keyframe interval %u\n", rec.keyframe_interval);
+    printf("keyframes         %zu, %zu bytes\n", rec.keyframes.size(), rec.snapshot_bytes);
+    printf("inputs            %zu bytes\n", rec.input_bytes);
+    printf("video             %s, %zu bytes\n", (rec.flags & REPLAY_FLAG_VIDEO) ? "yes" : "no", rec.video_bytes);
+    printf("total             %zu bytes (%.0f bytes/min)\n", rec.data.size(), minutes > 0 ? rec.data.size() / minutes : 0.0);
+    return 0;
+}
+
+static int cmd_seek(const Recording& rec, uint32_t frame) {
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    if (!seek(rec, frame, state)) {
+        fprintf(stderr, "frame %u is not in the recording\n", frame);
+        return 1;
+    }
+    printf("%u %016" PRIx64 "\n", frame, hash_screen(state));
+    delete state.game_instance;
+    return 0;
+}
+
+static int cmd_png(const Recording& rec, int argc, char** argv) {
+    uint32_t from = (uint32_t)atoi(argv[3]);
+    int count = atoi(argv[4]);
+    const char* out = argv[5];
+    int step = 1;
+    int scale = 4;
+    for (int i = 6; i < argc; ++i) {
+        if (!strcmp(argv[i], "--step") && i + 1 < argc) step = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--scale") && i + 1 < argc) scale = atoi(argv[++i]);
+    }
+    if (count < 1 || step < 1 || scale < 1) return 2;
+
+    const int GAP = 1; // Black column between frames
+    int frame_w = SCREEN_WIDTH * scale;
+    int width = count * (frame_w + GAP) - GAP;
+    int height = SCREEN_HEIGHT * scale;
+    std::vector<uint8_t> indices((size_t)width * height, 0);
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    if (!seek(rec, from, state)) {
+        fprintf(stderr, "frame %u is not in the recording\n", from);
+        return 1;
+    }
+    for (int i = 0; i < count; ++i) {
+        uint32_t frame = from + i * step;
+        if (i > 0) {
+            for (uint32_t f = frame - step + 1; f <= frame && f < rec.inputs.size(); ++f) {
+                update_game(state, rec.inputs[f] != 0);
+            }
+        }
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < frame_w; ++x) {
+                indices[(size_t)y * width + i * (frame_w + GAP) + x] = state.screen[y / scale][x / scale] & 7;
+            }
+        }
+    }
+    delete state.game_instance;
+    return write_png(out, indices, width, height) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && !strcmp(argv[1], "record")) return cmd_record(argc, argv);
+
+    Recording rec;
+    if (argc >= 3 && !load_recording(argv[2], rec)) return 1;
+    if (argc == 3 && !strcmp(argv[1], "info")) return cmd_info(rec);
+    if (argc == 4 && !strcmp(argv[1], "seek")) return cmd_seek(rec, (uint32_t)atoi(argv[3]));
+    if (argc >= 6 && !strcmp(argv[1], "png")) return cmd_png(rec, argc, argv);
+
+    fprintf(stderr,
+            "usage: %s record OUT [--game N] [--seed S] [--frames F] [--video]\n"
+            "       %s info FILE\n"
+            "       %s seek FILE FRAME\n"
+            "       %s png FILE FROM COUNT OUT.png [--step K] [--scale S]\n",
+            argv[0], argv[0], argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,220 @@
+// Headless native runner for the core game logic.
+//
+// Replays a fixed seed and a scripted button sequence through update_game()
+// and hashes every frame, so refactors can be checked against golden files.
+//
+//   runner [--game N] [--seed S] [--frames F]   print "frame hash" per frame
+//   runner --check DIR                          compare all games with DIR/<game>.txt
+//   runner --update DIR                         rewrite the golden files in DIR
+//   runner --stream [--fps R] [--game N] ...    write frames as a frame stream to stdout,
+//                                               R frames per second in real time if given
+//   runner --mem [--game N] ...                 print memory telemetry after the replay
+//   runner --trace FILE [--game N] ...          write the event trace as Chrome trace JSON
+//                                               (build/runner_trace, built with -DPOCHI_TRACE)
+
+#include "game_logic.h"
+#include "input_script.h"
+#include "frame_stream.h"
+#include "mem_stats.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <chrono>
+#include <thread>
+
+// --- Replay Constants ---
+const int DEFAULT_FRAMES = 1800;
+const int GOLDEN_CHECKPOINT_FRAMES = 10; // One golden line per 10 chained frame hashes
+const char* GAME_NAMES[NUM_GAMES] = {"jump", "chase", "fill", "brightness"};
+
+static void print_mem_stats(FILE* out) {
+    MemStats stats;
+    mem_stats_get(&stats);
+    fprintf(out, "heap current %u, peak %u, allocations %u, failures %u\n",
+            stats.heap_current, stats.heap_peak, stats.heap_allocs, stats.heap_failures);
+    fprintf(out, "sizeof GameState %u, JumpGame %u, ChaseGame %u, FillGame %u, BrightnessGame %u, GameInstanceStorage %u\n",
+            stats.sizeof_game_state, stats.sizeof_jump_game, stats.sizeof_chase_game,
+            stats.sizeof_fill_game, stats.sizeof_brightness_game, stats.sizeof_instance_storage);
+}
+
+// --- Chrome Trace Export ---
+// Frames become duration events ("B"/"E"), everything else instant events.
+// Load the file in chrome://tracing or ui.perfetto.dev.
+#ifdef POCHI_TRACE
+static bool write_chrome_trace(const char* path) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) return false;
+    TraceSnapshot* snap = trace_snapshot();
+    fprintf(fp, "{\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"update_game\"}}");
+    bool frame_open = false;
+    for (uint32_t i = 0; i < snap->count; ++i) {
+        const TraceEvent& e = snap->events[i];
+        const char* ph = "i";
+        if (e.type == TRACE_FRAME_BEGIN) {
+            ph = "B";
+            frame_open = true;
+        } else if (e.type == TRACE_FRAME_END) {
+            if (!frame_open) continue; // Its begin was overwritten in the ring
+            ph = "E";
+            frame_open = false;
+        }
+        fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"%s\",%s\"ts\":%u,\"pid\":1,\"tid\":1,\"args\":{\"arg\":%d}}",
+                trace_event_name(e.type), ph, ph[0] == 'i' ? "\"s\":\"t\"," : "", e.ts_us, e.arg);
+    }
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%u}}\n", snap->dropped);
+    fclose(fp);
+    return true;
+}
+#endif
+
+// --- Replay ---
+// Fills hashes[] with the per-frame screen hash. If stream_out is set, every
+// frame is also written to it as a frame stream packet, paced to stream_fps
+// frames per second when that is not 0 (a live source for spectator_server).
+static void replay(int game, uint32_t seed, int frames, uint64_t* hashes, FILE* stream_out, double stream_fps) {
+    static FrameStreamEncoder encoder;
+    frame_stream_encoder_init(encoder);
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    game_srand(seed);
+    set_initial_game(state);
+
+    InputScript script;
+    input_script_init(script, game, seed);
+    std::chrono::steady_clock::time_point next_frame = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        update_game(state, input_script_next(script));
+        hashes[i] = hash_screen(state);
+        if (stream_out) {
+            uint8_t packet[FRAME_STREAM_MAX_PACKET];
+            int len = frame_stream_encode(encoder, state.screen, packet);
+            fwrite(packet, 1, len, stream_out);
+            if (stream_fps > 0) {
+                fflush(stream_out);
+                next_frame += std::chrono::microseconds((long long)(1e6 / stream_fps));
+                std::this_thread::sleep_until(next_frame);
+            }
+        }
+    }
+    delete state.game_instance;
+}
+
+static uint64_t chain_hash(uint64_t chained, uint64_t frame_hash) {
+    return (chained ^ frame_hash) * 0x100000001B3ull;
+}
+
+// Runs every game with its fixed seed and either writes or checks DIR/<game>.txt.
+// Returns the number of games that did not match.
+static int run_golden(const char* dir, bool update) {
+    static uint64_t hashes[DEFAULT_FRAMES];
+    int failures = 0;
+    for (int game = 0; game < NUM_GAMES; ++game) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.txt", dir, GAME_NAMES[game]);
+        replay(game, 1 + game, DEFAULT_FRAMES, hashes, NULL, 0);
+
+        FILE* fp = fopen(path, update ? "w" : "r");
+        if (!fp) {
+            fprintf(stderr, "%s: cannot open %s\n", GAME_NAMES[game], path);
+            failures++;
+            continue;
+        }
+
+        uint64_t chained = 0;
+        int mismatch_frame = -1;
+        for (int i = 0; i < DEFAULT_FRAMES; ++i) {
+            chained = chain_hash(chained, hashes[i]);
+            if ((i + 1) % GOLDEN_CHECKPOINT_FRAMES != 0) continue;
+            if (update) {
+                fprintf(fp, "%d %016" PRIx64 "\n", i, chained);
+            } else {
+                int golden_frame;
+                uint64_t golden;
+                if (fscanf(fp, "%d %" SCNx64, &golden_frame, &golden) != 2 ||
+                    golden_frame != i || golden != chained) {
+                    mismatch_frame = i + 1 - GOLDEN_CHECKPOINT_FRAMES;
+                    break;
+                }
+            }
+        }
+        fclose(fp);
+
+        if (update) {
+            printf("%-10s written %s\n", GAME_NAMES[game], path);
+        } else if (mismatch_frame >= 0) {
+            printf("%-10s FAIL first difference in frames %d-%d\n", GAME_NAMES[game],
+                   mismatch_frame, mismatch_frame + GOLDEN_CHECKPOINT_FRAMES - 1);
+            failures++;
+        } else {
+            printf("%-10s ok\n", GAME_NAMES[game]);
+        }
+    }
+    return failures;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--stream [--fps R]] [--mem] [--trace FILE] [--game N] [--seed S] [--frames F] | --check DIR | --update DIR\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    int game = GAME_JUMP;
+    uint32_t seed = 1;
+    int frames = DEFAULT_FRAMES;
+    bool stream = false;
+    double fps = 0;
+    bool mem = false;
+    const char* trace_path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--check") && i + 1 < argc) {
+            return run_golden(argv[++i], false) ? 1 : 0;
+        } else if (!strcmp(argv[i], "--update") && i + 1 < argc) {
+            return run_golden(argv[++i], true) ? 1 : 0;
+        } else if (!strcmp(argv[i], "--mem")) {
+            mem = true;
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (!strcmp(argv[i], "--stream")) {
+            stream = true;
+        } else if (!strcmp(argv[i], "--fps") && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--game") && i + 1 < argc) {
+            game = atoi(argv[++i]) % NUM_GAMES;
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+            if (frames < 1) return usage(argv[0]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+#ifndef POCHI_TRACE
+    if (trace_path) {
+        fprintf(stderr, "%s: built without tracing, use build/runner_trace\n", argv[0]);
+        return 2;
+    }
+#endif
+
+    uint64_t* hashes = new uint64_t[frames];
+    replay(game, seed, frames, hashes, stream ? stdout : NULL, fps);
+    for (int i = 0; !stream && !mem && !trace_path && i < frames; ++i) {
+        printf("%d %016" PRIx64 "\n", i, hashes[i]);
+    }
+    if (mem) print_mem_stats(stdout);
+#ifdef POCHI_TRACE
+    if (trace_path && !write_chrome_trace(trace_path)) {
+        fprintf(stderr, "cannot write %s\n", trace_path);
+        delete[] hashes;
+        return 1;
+    }
+#endif
+    delete[] hashes;
+    return 0;
+}
@@ -0,0 +1,355 @@
+// Load generator for spectator_server: many WebSocket viewers on localhost.
+//
+// Opens --clients connections from one epoll loop, performs the handshake,
+// and decodes every frame with the same FrameStreamDecoder the board viewer
+// uses. Each frame's latency is the time from server ingest to decode. The
+// server stamps its CLOCK_MONOTONIC into every message, so this only works on
+// the same host. --slow K makes K viewers read only every --slow-ms (1000) with
+// a small receive buffer. Once a stall outgrows the server's --queue-kb, the
+// server should resync them with keyframes, and the other viewers' latency
+// should stay flat. A viewer that decodes a corrupt or
+// out-of-sequence packet counts as a failure.
+//
+//   spectator_load [--host A.B.C.D] [--port P] [--clients N] [--seconds S] [--slow K] [--slow-ms MS]
+//                  [--per-viewer]
+//   ./build/runner --stream --fps 60 --frames 3600 | ./build/spectator_server &
+//   ./build/spectator_load --clients 500 --seconds 30 --slow 10
+
+#include "frame_stream.h"
+#include "websocket.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <vector>
+
+// --- Load Constants ---
+const int MAX_EPOLL_EVENTS = 256;
+const size_t IN_BUFFER = 16384;
+const int DEFAULT_SLOW_READ_MS = 1000;
+const int SLOW_RCVBUF = 4096;
+
+enum ViewerState {
+    VIEWER_CONNECTING,
+    VIEWER_HANDSHAKE, // Request sent, waiting for 101
+    VIEWER_STREAMING,
+    VIEWER_FAILED,
+    VIEWER_CLOSED     // The server went away
+};
+
+struct Viewer {
+    int fd;
+    uint8_t state;
+    bool slow;
+    char accept[WS_ACCEPT_LENGTH + 1]; // Expected Sec-WebSocket-Accept
+    uint8_t in[IN_BUFFER + 1];
+    size_t in_len;
+    FrameStreamDecoder decoder;
+    uint32_t decode_errors;
+    std::vector<uint32_t> latency_us;
+};
+
+static int s_epoll = -1;
+
+static uint32_t s_rng = 0x2545F491;
+static uint32_t load_rand() {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static void fail(Viewer& v, const char* why) {
+    if (v.state == VIEWER_STREAMING || v.state == VIEWER_CLOSED) return;
+    fprintf(stderr, "viewer on fd %d: %s\n", v.fd, why);
+    v.state = VIEWER_FAILED;
+}
+
+static void send_handshake(Viewer& v, const char* host, int port) {
+    uint8_t nonce[16];
+    for (int i = 0; i < 16; ++i) nonce[i] = (uint8_t)load_rand();
+    char key[WS_KEY_LENGTH + 1];
+    base64_encode(nonce, sizeof(nonce), key);
+    ws_accept_key(key, v.accept);
+
+    char request[512];
+    int len = snprintf(request, sizeof(request),
+                       "GET %s HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                       "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n",
+                       SPECTATOR_PATH, host, port, key);
+    if (send(v.fd, request, len, MSG_NOSIGNAL) != len) { // Fits any fresh socket buffer
+        fail(v, "cannot send the handshake");
+        return;
+    }
+    v.state = VIEWER_HANDSHAKE;
+}
+
+// One complete binary message: spectator header, then a frame stream packet
+static void on_message(Viewer& v, const uint8_t* payload, size_t len, uint32_t now_us) {
+    if (len < SPECTATOR_HEADER_SIZE) {
+        v.decode_errors++;
+        return;
+    }
+    uint32_t ingest_us = 0;
+    for (int i = 0; i < 4; ++i) ingest_us |= (uint32_t)payload[4 + i] << (i * 8);
+    uint32_t dropped = v.decoder.dropped;
+    bool decoded = false;
+    for (size_t i = SPECTATOR_HEADER_SIZE; i < len; ++i) {
+        decoded = frame_stream_decode_byte(v.decoder, payload[i]);
+    }
+    // Every message is exactly one packet that must apply cleanly
+    if (!decoded || v.decoder.dropped != dropped) {
+        v.decode_errors++;
+        return;
+    }
+    v.latency_us.push_back(now_us - ingest_us);
+}
+
+static void parse_frames(Viewer& v) {
+    uint32_t now_us = spectator_clock_us();
+    size_t pos = 0;
+    WsFrameHeader header;
+    while (ws_parse_header(v.in + pos, v.in_len - pos, header)) {
+        size_t total = header.header_len + (size_t)header.payload_len;
+        if (header.masked || total > IN_BUFFER) {
+            v.decode_errors++;
+            v.state = VIEWER_CLOSED;
+            return;
+        }
+        if (v.in_len - pos < total) break;
+        if (header.opcode == WS_OPCODE_BINARY) {
+            on_message(v, v.in + pos + header.header_len, (size_t)header.payload_len, now_us);
+        } else if (header.opcode == WS_OPCODE_CLOSE) {
+            v.state = VIEWER_CLOSED;
+        }
+        pos += total;
+    }
+    memmove(v.in, v.in + pos, v.in_len - pos);
+    v.in_len -= pos;
+}
+
+static void on_readable(Viewer& v) {
+    for (;;) {
+        ssize_t n = recv(v.fd, v.in + v.in_len, IN_BUFFER - v.in_len, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            fail(v, "connection closed during the handshake");
+            if (v.state == VIEWER_STREAMING) v.state = VIEWER_CLOSED;
+            epoll_ctl(s_epoll, EPOLL_CTL_DEL, v.fd, NULL);
+            return;
+        }
+        if (n < 0) return;
+        v.in_len += (size_t)n;
+
+        if (v.state == VIEWER_HANDSHAKE) {
+            v.in[v.in_len] = '\0';
+            char* end = strstr((char*)v.in, "\r\n\r\n");
+            if (!end) continue;
+            char accept[64];
+            if (strncmp((char*)v.in, "HTTP/1.1 101", 12) != 0 ||
+                !http_header_value((char*)v.in, "Sec-WebSocket-Accept", accept, sizeof(accept)) ||
+                strcmp(accept, v.accept) != 0) {
+                fail(v, "bad handshake response");
+                epoll_ctl(s_epoll, EPOLL_CTL_DEL, v.fd, NULL);
+                return;
+            }
+            v.state = VIEWER_STREAMING;
+            size_t used = (size_t)(end + 4 - (char*)v.in);
+            memmove(v.in, v.in + used, v.in_len - used);
+            v.in_len -= used;
+        }
+        if (v.state == VIEWER_STREAMING) parse_frames(v);
+        if (v.state == VIEWER_CLOSED) {
+            epoll_ctl(s_epoll, EPOLL_CTL_DEL, v.fd, NULL);
+            return;
+        }
+    }
+}
+
+// --- Report ---
+struct LatencySummary {
+    uint32_t p50, p99, max;
+};
+
+static LatencySummary summarize(std::vector<uint32_t>& samples) {
+    LatencySummary s = {0, 0, 0};
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    s.p50 = samples[samples.size() / 2];
+    s.p99 = samples[(samples.size() * 99) / 100];
+    s.max = samples.back();
+    return s;
+}
+
+static void report_group(const char* name, std::vector<Viewer*>& group) {
+    if (group.empty()) return;
+    std::vector<uint32_t> all;
+    uint32_t min_frames = UINT32_MAX, max_frames = 0, keyframes = 0;
+    uint32_t worst_p99 = 0;
+    for (size_t i = 0; i < group.size(); ++i) {
+        Viewer& v = *group[i];
+        uint32_t frames = (uint32_t)v.latency_us.size();
+        min_frames = std::min(min_frames, frames);
+        max_frames = std::max(max_frames, frames);
+        keyframes += v.decoder.keyframes;
+        all.insert(all.end(), v.latency_us.begin(), v.latency_us.end());
+        std::vector<uint32_t> own = v.latency_us;
+        worst_p99 = std::max(worst_p99, summarize(own).p99);
+    }
+    LatencySummary s = summarize(all);
+    printf("%s viewers: %zu, frames per viewer %u-%u, %.1f keyframes per viewer\n", name, group.size(),
+           min_frames, max_frames, (double)keyframes / group.size());
+    printf("  latency p50 %.2f ms, p99 %.2f ms, max %.2f ms; worst viewer p99 %.2f ms\n", s.p50 / 1e3,
+           s.p99 / 1e3, s.max / 1e3, worst_p99 / 1e3);
+}
+
+// --- Main ---
+int main(int argc, char** argv) {
+    const char* host = "127.0.0.1";
+    int port = SPECTATOR_DEFAULT_PORT;
+    int clients = 100;
+    int seconds = 10;
+    int slow = 0;
+    int slow_ms = DEFAULT_SLOW_READ_MS;
+    bool per_viewer = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--host") && i + 1 < argc) {
+            host = argv[++i];
+        } else if (!strcmp(argv[i], "--port") && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--clients") && i + 1 < argc) {
+            clients = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--slow") && i + 1 < argc) {
+            slow = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--slow-ms") && i + 1 < argc) {
+            slow_ms = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--per-viewer")) {
+            per_viewer = true;
+        } else {
+            fprintf(stderr, "usage: %s [--host A.B.C.D] [--port P] [--clients N] [--seconds S] [--slow K] "
+                            "[--slow-ms MS] [--per-viewer]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        fprintf(stderr, "bad address %s\n", host);
+        return 2;
+    }
+
+    s_epoll = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Viewer*> viewers;
+    for (int i = 0; i < clients; ++i) {
+        Viewer* v = new Viewer;
+        v->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        v->state = VIEWER_CONNECTING;
+        v->slow = i < slow;
+        v->in_len = 0;
+        v->decode_errors = 0;
+        frame_stream_decoder_init(v->decoder);
+        viewers.push_back(v);
+        if (v->fd < 0) {
+            fail(*v, strerror(errno));
+            continue;
+        }
+        if (v->slow) {
+            int size = SLOW_RCVBUF;
+            setsockopt(v->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        }
+        if (connect(v->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+            fail(*v, strerror(errno));
+            continue;
+        }
+        struct epoll_event ev;
+        ev.events = EPOLLOUT; // Connected
+        ev.data.ptr = v;
+        epoll_ctl(s_epoll, EPOLL_CTL_ADD, v->fd, &ev);
+    }
+
+    uint32_t start = spectator_clock_us();
+    uint32_t last_slow_read = start;
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    while (spectator_clock_us() - start < (uint32_t)seconds * 1000000u) {
+        int n = epoll_wait(s_epoll, events, MAX_EPOLL_EVENTS, 100);
+        for (int i = 0; i < n; ++i) {
+            Viewer& v = *(Viewer*)events[i].data.ptr;
+            if (v.state == VIEWER_CONNECTING) {
+                int err = 0;
+                socklen_t err_len = sizeof(err);
+                getsockopt(v.fd, SOL_SOCKET, SO_ERROR, &err, &err_len);
+                if (err) {
+                    fail(v, strerror(err));
+                    epoll_ctl(s_epoll, EPOLL_CTL_DEL, v.fd, NULL);
+                    continue;
+                }
+                send_handshake(v, host, port);
+                struct epoll_event ev;
+                ev.events = EPOLLIN;
+                ev.data.ptr = &v;
+                // Slow viewers are only read by the timer below
+                epoll_ctl(s_epoll, v.slow ? EPOLL_CTL_DEL : EPOLL_CTL_MOD, v.fd, &ev);
+                continue;
+            }
+            on_readable(v);
+        }
+
+        uint32_t now = spectator_clock_us();
+        if (now - last_slow_read >= (uint32_t)slow_ms * 1000u) {
+            last_slow_read = now;
+            for (int i = 0; i < slow && i < clients; ++i) {
+                Viewer& v = *viewers[i];
+                if (v.state == VIEWER_HANDSHAKE || v.state == VIEWER_STREAMING) on_readable(v);
+            }
+        }
+    }
+
+    // --- Report ---
+    std::vector<Viewer*> fast_group, slow_group;
+    int failed = 0, closed = 0;
+    uint32_t errors = 0;
+    for (size_t i = 0; i < viewers.size(); ++i) {
+        Viewer& v = *viewers[i];
+        failed += v.state == VIEWER_FAILED || v.state == VIEWER_CONNECTING || v.state == VIEWER_HANDSHAKE;
+        closed += v.state == VIEWER_CLOSED;
+        errors += v.decode_errors;
+        (v.slow ? slow_group : fast_group).push_back(&v);
+    }
+    printf("%d viewers for %d s: %d failed to connect, %d disconnected by the server, %u decode errors\n",
+           clients, seconds, failed, closed, errors);
+    report_group("fast", fast_group);
+    report_group("slow", slow_group);
+    if (per_viewer) {
+        for (size_t i = 0; i < viewers.size(); ++i) {
+            Viewer& v = *viewers[i];
+            uint32_t frames = (uint32_t)v.latency_us.size();
+            LatencySummary s = summarize(v.latency_us);
+            printf("viewer %4zu%s: %u frames, %u keyframes, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", i,
+                   v.slow ? " (slow)" : "", frames, v.decoder.keyframes, s.p50 / 1e3, s.p99 / 1e3, s.max / 1e3);
+        }
+    }
+
+    for (size_t i = 0; i < viewers.size(); ++i) {
+        if (viewers[i]->fd >= 0) close(viewers[i]->fd);
+        delete viewers[i];
+    }
+    return failed || errors ? 1 : 0;
+}
@@ -0,0 +1,599 @@
+// Spectator fan-out server: shows one live game on many browser screens.
+//
+// Reads a frame stream (src/frame_stream.h) from the headless runner or from a
+// board's Serial mirror and serves it over WebSocket to every connected viewer
+// from a single epoll loop.
+//   - One encode per frame: each frame is encoded once into a reference-counted
+//     WebSocket message, and every viewer's send queue points at that message.
+//   - Keyframe catch-up: a late joiner gets a keyframe of the current frame
+//     straight away and then follows the shared deltas. The keyframe is encoded
+//     at most once per frame, and only when someone needs it.
+//   - Per-viewer backpressure: a viewer whose socket stops draining may queue
+//     at most --queue-kb. Past that its queue is dropped, and it is resynced with
+//     a keyframe, so one stuck screen never delays the others or grows memory.
+// GET / serves public/spectator.html (--www DIR). GET /ws upgrades to the stream
+// (see tools/websocket.h for the message layout). The server exits when the
+// input ends.
+//
+//   spectator_server [--port P] [--input PATH] [--www DIR] [--queue-kb K] [--max-clients N]
+//   ./build/runner --stream --fps 60 --frames 216000 | ./build/spectator_server
+//   ./build/spectator_server --input /dev/ttyUSB0       (115200 8N1 raw, like stream_viewer)
+//   ./build/spectator_load --clients 500 --seconds 30   (load test on localhost)
+
+#include "frame_stream.h"
+#include "websocket.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+
+// --- Server Constants ---
+const int MAX_EPOLL_EVENTS = 256;
+const int CLIENT_QUEUE_LEN = 64;          // Messages a viewer can have in flight
+const int DEFAULT_QUEUE_KB = 16;          // ~100 frames of deltas
+const int DEFAULT_MAX_CLIENTS = 4096;
+const int NON_CLIENT_FDS = 16;            // stdio, input, listener, epoll, reserve, --www files, slack
+const size_t MAX_REQUEST = 4096;          // HTTP request, then incoming WebSocket frames
+const int STATS_INTERVAL_MS = 5000;
+const int CLIENT_SNDBUF = 8192;           // Small, so stale frames wait in our queue where they can be dropped
+const speed_t SERIAL_BAUD = B115200;
+const size_t MAX_MESSAGE = WS_MAX_HEADER + SPECTATOR_HEADER_SIZE + FRAME_STREAM_MAX_PACKET;
+
+// --- Messages ---
+// One encoded WebSocket frame, shared by every viewer that queued it
+struct Message {
+    int refs;
+    uint32_t len;
+    bool keyframe;
+    uint8_t data[MAX_MESSAGE];
+    Message* next_free;
+};
+
+static Message* s_free_messages = NULL;
+
+static Message* message_alloc() {
+    Message* msg = s_free_messages;
+    if (msg) s_free_messages = msg->next_free;
+    else msg = new Message;
+    msg->refs = 1;
+    msg->len = 0;
+    return msg;
+}
+
+static void message_release(Message* msg) {
+    if (!msg || --msg->refs > 0) return;
+    msg->next_free = s_free_messages;
+    s_free_messages = msg;
+}
+
+// --- Clients ---
+enum ClientState {
+    CLIENT_HTTP,   // Reading the request
+    CLIENT_VIEWER, // Upgraded, receiving frames
+    CLIENT_CLOSING // Sending a plain HTTP response, then closing
+};
+
+struct Client {
+    int fd;
+    int index;              // In s_clients
+    uint8_t state;
+    bool writable_wanted;   // EPOLLOUT is registered
+    bool needs_keyframe;    // Queue was dropped or just joined: next message must be a keyframe
+    char in[MAX_REQUEST + 1];
+    size_t in_len;
+    std::string raw;        // HTTP response bytes, sent before any message
+    Message* queue[CLIENT_QUEUE_LEN];
+    int head;
+    int count;
+    size_t head_offset;     // Bytes of queue[head] already sent
+    size_t queued_bytes;
+};
+
+struct ServerStats {
+    uint64_t frames;
+    uint64_t encoded_bytes;  // Once per frame, as encoded
+    uint64_t sent_bytes;     // Summed over viewers
+    uint32_t keyframes;      // Catch-up keyframes encoded
+    uint32_t resyncs;        // Queues dropped by backpressure
+    uint32_t joined;
+    uint32_t rejected;
+};
+
+static std::vector<Client*> s_clients;
+static int s_epoll = -1;
+static ServerStats s_stats;
+static size_t s_queue_limit = DEFAULT_QUEUE_KB * 1024;
+static const char* s_www = "public";
+
+// epoll user data for the two non-client descriptors
+static int s_listen_tag, s_input_tag;
+
+static void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void update_interest(Client* c) {
+    bool want = !c->raw.empty() || c->count > 0;
+    if (want == c->writable_wanted) return;
+    c->writable_wanted = want;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | (want ? (uint32_t)EPOLLOUT : 0u);
+    ev.data.ptr = c;
+    epoll_ctl(s_epoll, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+// The Client itself is freed after the current batch of epoll events, which
+// may still point at it
+static std::vector<Client*> s_closed;
+
+static void close_client(Client* c) {
+    epoll_ctl(s_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    for (int i = 0; i < c->count; ++i) message_release(c->queue[(c->head + i) % CLIENT_QUEUE_LEN]);
+    c->count = 0;
+    Client* last = s_clients.back();
+    s_clients[c->index] = last;
+    last->index = c->index;
+    s_clients.pop_back();
+    s_closed.push_back(c);
+}
+
+// Sends as much as the socket takes. Returns false if the client was closed.
+static bool flush_client(Client* c) {
+    while (!c->raw.empty()) {
+        ssize_t n = send(c->fd, c->raw.data(), c->raw.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            close_client(c);
+            return false;
+        }
+        c->raw.erase(0, (size_t)n);
+    }
+    while (c->raw.empty() && c->count > 0) {
+        struct iovec iov[CLIENT_QUEUE_LEN];
+        for (int i = 0; i < c->count; ++i) {
+            Message* msg = c->queue[(c->head + i) % CLIENT_QUEUE_LEN];
+            size_t skip = i == 0 ? c->head_offset : 0;
+            iov[i].iov_base = msg->data + skip;
+            iov[i].iov_len = msg->len - skip;
+        }
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = iov;
+        mh.msg_iovlen = c->count;
+        ssize_t n = sendmsg(c->fd, &mh, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            close_client(c);
+            return false;
+        }
+        s_stats.sent_bytes += (uint64_t)n;
+        size_t left = (size_t)n;
+        while (left > 0) {
+            Message* msg = c->queue[c->head];
+            size_t rest = msg->len - c->head_offset;
+            if (left < rest) {
+                c->head_offset += left;
+                break;
+            }
+            left -= rest;
+            c->queued_bytes -= msg->len;
+            message_release(msg);
+            c->head = (c->head + 1) % CLIENT_QUEUE_LEN;
+            c->count--;
+            c->head_offset = 0;
+        }
+    }
+    if (c->state == CLIENT_CLOSING && c->raw.empty()) {
+        close_client(c);
+        return false;
+    }
+    update_interest(c);
+    return true;
+}
+
+// Drops every queued message that has not started going out
+static void drop_queue(Client* c) {
+    int keep = c->head_offset > 0 ? 1 : 0; // A half-sent frame must finish or the stream breaks
+    for (int i = keep; i < c->count; ++i) {
+        Message* msg = c->queue[(c->head + i) % CLIENT_QUEUE_LEN];
+        c->queued_bytes -= msg->len;
+        message_release(msg);
+    }
+    c->count = keep;
+}
+
+static void enqueue(Client* c, Message* msg) {
+    msg->refs++;
+    c->queue[(c->head + c->count) % CLIENT_QUEUE_LEN] = msg;
+    c->count++;
+    c->queued_bytes += msg->len;
+}
+
+// --- Frames ---
+static uint8_t s_screen[SCREEN_HEIGHT][SCREEN_WIDTH];
+static bool s_have_frame = false;
+static FrameStreamEncoder s_encoder;
+static FrameStreamEncoder s_encoder_before; // State before the current frame's delta, for its keyframe
+static uint32_t s_frame_ingest_us;
+static Message* s_delta = NULL;             // Current frame, as everyone gets it
+static Message* s_keyframe = NULL;          // Current frame as a keyframe, encoded on demand
+
+static Message* build_message(FrameStreamEncoder& encoder, uint32_t frame, uint32_t ingest_us) {
+    uint8_t payload[SPECTATOR_HEADER_SIZE + FRAME_STREAM_MAX_PACKET];
+    for (int i = 0; i < 4; ++i) {
+        payload[i] = (uint8_t)(frame >> (i * 8));
+        payload[4 + i] = (uint8_t)(ingest_us >> (i * 8));
+    }
+    int len = SPECTATOR_HEADER_SIZE + frame_stream_encode(encoder, s_screen, payload + SPECTATOR_HEADER_SIZE);
+
+    Message* msg = message_alloc();
+    int header = ws_write_header(msg->data, WS_OPCODE_BINARY, (uint64_t)len, NULL);
+    memcpy(msg->data + header, payload, len);
+    msg->len = (uint32_t)(header + len);
+    msg->keyframe = payload[SPECTATOR_HEADER_SIZE + 1] == FRAME_STREAM_KEYFRAME;
+    s_stats.encoded_bytes += msg->len;
+    return msg;
+}
+
+// The current frame as a keyframe with the same sequence number as its delta,
+// so the next shared delta follows on from it
+static Message* current_keyframe() {
+    if (s_delta && s_delta->keyframe) return s_delta;
+    if (!s_keyframe) {
+        FrameStreamEncoder encoder = s_encoder_before;
+        frame_stream_request_keyframe(encoder);
+        s_keyframe = build_message(encoder, (uint32_t)s_stats.frames - 1, s_frame_ingest_us);
+        s_stats.keyframes++;
+    }
+    return s_keyframe;
+}
+
+static void send_to(Client* c) {
+    Message* msg = c->needs_keyframe ? current_keyframe() : s_delta;
+    if (c->count == CLIENT_QUEUE_LEN || c->queued_bytes + msg->len > s_queue_limit) {
+        drop_queue(c);
+        s_stats.resyncs++;
+        msg = current_keyframe();
+    }
+    enqueue(c, msg);
+    c->needs_keyframe = false;
+    flush_client(c);
+}
+
+static void broadcast_frame(const uint8_t screen[SCREEN_HEIGHT][SCREEN_WIDTH]) {
+    memcpy(s_screen, screen, sizeof(s_screen));
+    s_have_frame = true;
+    s_frame_ingest_us = spectator_clock_us();
+
+    message_release(s_delta);
+    message_release(s_keyframe);
+    s_keyframe = NULL;
+    s_encoder_before = s_encoder;
+    s_delta = build_message(s_encoder, (uint32_t)s_stats.frames, s_frame_ingest_us);
+    s_stats.frames++;
+
+    // Backwards: send_to() may close a client, which moves the last one into its slot
+    for (size_t i = s_clients.size(); i-- > 0;) {
+        if (i < s_clients.size() && s_clients[i]->state == CLIENT_VIEWER) send_to(s_clients[i]);
+    }
+}
+
+// --- HTTP ---
+static void respond(Client* c, const char* status, const char* type, const std::string& body) {
+    char header[256];
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nCache-Control: no-store\r\n"
+             "Connection: close\r\n\r\n", status, type, body.size());
+    c->raw = header;
+    c->raw += body;
+    c->state = CLIENT_CLOSING;
+}
+
+static bool read_file(const char* path, std::string& out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) out.append(buf, n);
+    fclose(fp);
+    return true;
+}
+
+static void handle_request(Client* c) {
+    char method[8], path[256];
+    if (sscanf(c->in, "%7s %255s", method, path) != 2 || strcmp(method, "GET") != 0) {
+        respond(c, "405 Method Not Allowed", "text/plain", "GET only\n");
+        return;
+    }
+    char key[64], upgrade[32];
+    if (!strcmp(path, SPECTATOR_PATH) && http_header_value(c->in, "Upgrade", upgrade, sizeof(upgrade)) &&
+        !strcasecmp(upgrade, "websocket") && http_header_value(c->in, "Sec-WebSocket-Key", key, sizeof(key))) {
+        char accept[WS_ACCEPT_LENGTH + 1];
+        ws_accept_key(key, accept);
+        c->raw = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                 "Sec-WebSocket-Accept: ";
+        c->raw += accept;
+        c->raw += "\r\n\r\n";
+        c->state = CLIENT_VIEWER;
+        c->in_len = 0;
+        s_stats.joined++;
+        if (s_have_frame) {
+            // Catch up right away instead of waiting for the next frame
+            enqueue(c, current_keyframe());
+        } else {
+            c->needs_keyframe = true;
+        }
+        return;
+    }
+    if (!strcmp(path, "/") || !strcmp(path, "/spectator.html")) {
+        std::string page;
+        std::string file = std::string(s_www) + "/spectator.html";
+        if (read_file(file.c_str(), page)) respond(c, "200 OK", "text/html; charset=utf-8", page);
+        else respond(c, "404 Not Found", "text/plain", file + " not found (see --www)\n");
+        return;
+    }
+    respond(c, "404 Not Found", "text/plain", "not found\n");
+}
+
+// Viewers send nothing but pings and close; anything else is read and ignored
+static bool handle_viewer_input(Client* c) {
+    size_t pos = 0;
+    WsFrameHeader header;
+    while (ws_parse_header((const uint8_t*)c->in + pos, c->in_len - pos, header)) {
+        if (header.payload_len > MAX_REQUEST - (size_t)header.header_len) return false; // Can never fit
+        size_t total = header.header_len + (size_t)header.payload_len;
+        if (c->in_len - pos < total) break;
+        if (header.opcode == WS_OPCODE_CLOSE) return false;
+        pos += total;
+    }
+    memmove(c->in, c->in + pos, c->in_len - pos);
+    c->in_len -= pos;
+    return true;
+}
+
+static void on_client_readable(Client* c) {
+    for (;;) {
+        ssize_t n = recv(c->fd, c->in + c->in_len, MAX_REQUEST - c->in_len, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close_client(c);
+            return;
+        }
+        if (n < 0) break;
+        c->in_len += (size_t)n;
+        c->in[c->in_len] = '\0';
+
+        if (c->state == CLIENT_HTTP) {
+            if (strstr(c->in, "\r\n\r\n")) {
+                handle_request(c);
+                flush_client(c); // May close the client
+                return;
+            }
+            if (c->in_len == MAX_REQUEST) {
+                close_client(c);
+                return;
+            }
+        } else if (c->state == CLIENT_VIEWER) {
+            if (!handle_viewer_input(c)) {
+                close_client(c);
+                return;
+            }
+        } else {
+            c->in_len = 0; // Closing: discard
+        }
+    }
+}
+
+// Held open so that, out of descriptors, a pending connection can still be
+// accepted and closed; otherwise it stays queued and the level-triggered
+// listener wakes epoll_wait forever
+static int s_reserve_fd = -1;
+
+static void accept_clients(int listen_fd, int max_clients) {
+    for (;;) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0 && (errno == EMFILE || errno == ENFILE) && s_reserve_fd >= 0) {
+            close(s_reserve_fd);
+            fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd >= 0) close(fd);
+            s_reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return;
+            s_stats.rejected++;
+            continue;
+        }
+        if (fd < 0) return;
+        if ((int)s_clients.size() >= max_clients) {
+            close(fd);
+            s_stats.rejected++;
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Frames are small and latency-bound
+        int sndbuf = CLIENT_SNDBUF;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+        Client* c = new Client;
+        c->fd = fd;
+        c->index = (int)s_clients.size();
+        c->state = CLIENT_HTTP;
+        c->writable_wanted = false;
+        c->needs_keyframe = false;
+        c->in_len = 0;
+        c->head = c->count = 0;
+        c->head_offset = c->queued_bytes = 0;
+        s_clients.push_back(c);
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        epoll_ctl(s_epoll, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// --- Input ---
+static void configure_serial(int fd) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return; // Not a tty (pipe)
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, SERIAL_BAUD);
+    cfsetospeed(&tio, SERIAL_BAUD);
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+// Returns false at the end of the input
+static bool read_input(int fd, FrameStreamDecoder& decoder) {
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n == 0) return false;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (frame_stream_decode_byte(decoder, buf[i])) broadcast_frame(decoder.screen);
+        }
+    }
+}
+
+static void print_stats(uint64_t frames_before, double seconds) {
+    int viewers = 0;
+    for (size_t i = 0; i < s_clients.size(); ++i) viewers += s_clients[i]->state == CLIENT_VIEWER;
+    double per_frame = s_stats.frames ? (double)s_stats.encoded_bytes / s_stats.frames : 0.0;
+    fprintf(stderr, "viewers %d  frames %llu (%.1f/s)  %.1f bytes/frame encoded  %.2f MB sent  "
+                    "keyframes %u  resyncs %u  rejected %u\n",
+            viewers, (unsigned long long)s_stats.frames, (s_stats.frames - frames_before) / seconds, per_frame,
+            s_stats.sent_bytes / 1e6, s_stats.keyframes, s_stats.resyncs, s_stats.rejected);
+}
+
+// --- Main ---
+int main(int argc, char** argv) {
+    int port = SPECTATOR_DEFAULT_PORT;
+    const char* input_path = NULL;
+    int max_clients = DEFAULT_MAX_CLIENTS;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--port") && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--input") && i + 1 < argc) {
+            input_path = argv[++i];
+        } else if (!strcmp(argv[i], "--www") && i + 1 < argc) {
+            s_www = argv[++i];
+        } else if (!strcmp(argv[i], "--queue-kb") && i + 1 < argc) {
+            s_queue_limit = (size_t)atoi(argv[++i]) * 1024;
+        } else if (!strcmp(argv[i], "--max-clients") && i + 1 < argc) {
+            max_clients = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--port P] [--input PATH] [--www DIR] [--queue-kb K] [--max-clients N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // Hundreds of viewers need more descriptors than the usual soft limit of 1024
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur != RLIM_INFINITY &&
+        (rlim_t)max_clients + NON_CLIENT_FDS > lim.rlim_cur) {
+        int fd_limit = lim.rlim_cur > (rlim_t)NON_CLIENT_FDS ? (int)(lim.rlim_cur - NON_CLIENT_FDS) : 1;
+        fprintf(stderr, "max clients %d capped to %d by the descriptor limit %llu\n", max_clients, fd_limit,
+                (unsigned long long)lim.rlim_cur);
+        max_clients = fd_limit;
+    }
+    s_reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    int input_fd = 0;
+    if (input_path) {
+        input_fd = open(input_path, O_RDONLY | O_NOCTTY);
+        if (input_fd < 0) {
+            perror(input_path);
+            return 1;
+        }
+    }
+    configure_serial(input_fd);
+    set_nonblocking(input_fd);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+        perror("listen");
+        return 1;
+    }
+
+    s_epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = &s_listen_tag;
+    epoll_ctl(s_epoll, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.ptr = &s_input_tag;
+    if (epoll_ctl(s_epoll, EPOLL_CTL_ADD, input_fd, &ev) < 0) {
+        fprintf(stderr, "input must be a pipe, socket or serial device (epoll: %s)\n", strerror(errno));
+        return 1;
+    }
+
+    static FrameStreamDecoder decoder;
+    frame_stream_decoder_init(decoder);
+    frame_stream_encoder_init(s_encoder);
+    fprintf(stderr, "spectator server on port %d, viewer at http://localhost:%d/\n", port, port);
+
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    uint32_t stats_mark = spectator_clock_us();
+    uint64_t frames_mark = 0;
+    bool running = true;
+    while (running) {
+        int n = epoll_wait(s_epoll, events, MAX_EPOLL_EVENTS, STATS_INTERVAL_MS);
+        for (int i = 0; i < n && running; ++i) {
+            void* tag = events[i].data.ptr;
+            if (tag == &s_listen_tag) {
+                accept_clients(listen_fd, max_clients);
+            } else if (tag == &s_input_tag) {
+                running = read_input(input_fd, decoder);
+            } else {
+                Client* c = (Client*)tag;
+                if (c->fd < 0) continue; // Closed earlier in this batch
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    close_client(c);
+                    continue;
+                }
+                if ((events[i].events & EPOLLOUT) && !flush_client(c)) continue;
+                if (events[i].events & EPOLLIN) on_client_readable(c);
+            }
+        }
+        for (size_t i = 0; i < s_closed.size(); ++i) delete s_closed[i];
+        s_closed.clear();
+
+        uint32_t now = spectator_clock_us();
+        if (now - stats_mark >= STATS_INTERVAL_MS * 1000u) {
+            print_stats(frames_mark, (now - stats_mark) / 1e6);
+            stats_mark = now;
+            frames_mark = s_stats.frames;
+        }
+    }
+
+    fprintf(stderr, "input ended after %llu frames, %u decoder drops\n", (unsigned long long)s_stats.frames,
+            decoder.dropped);
+    print_stats(frames_mark, (spectator_clock_us() - stats_mark) / 1e6 + 1e-6);
+    while (!s_clients.empty()) close_client(s_clients.back());
+    for (size_t i = 0; i < s_closed.size(); ++i) delete s_closed[i];
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Host-side viewer for the frame stream sent by simple-dot.ino (see
+// src/frame_stream.h). Reads from a serial device, a file or stdin and draws
+// every decoded frame in the terminal.
+//
+//   stream_viewer /dev/ttyUSB0          (configured as 115200 8N1 raw)
+//   ./build/runner --stream | ./build/stream_viewer
+
+#include "frame_stream.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+const speed_t SERIAL_BAUD = B115200;
+
+static void configure_serial(int fd) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return; // Not a tty (file or pipe)
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, SERIAL_BAUD);
+    cfsetospeed(&tio, SERIAL_BAUD);
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+// Palette indices 0-7 map directly onto the 8 ANSI background colours
+static void draw_frame(const FrameStreamDecoder& decoder, unsigned long bytes) {
+    char out[SCREEN_HEIGHT * (SCREEN_WIDTH * 8 + 8) + 256];
+    int len = snprintf(out, sizeof(out), "\x1b[H");
+    for (int r = 0; r < SCREEN_HEIGHT; ++r) {
+        for (int c = 0; c < SCREEN_WIDTH; ++c) {
+            len += snprintf(out + len, sizeof(out) - len, "\x1b[%dm  ", 40 + (decoder.screen[r][c] & 7));
+        }
+        len += snprintf(out + len, sizeof(out) - len, "\x1b[0m\n");
+    }
+    len += snprintf(out + len, sizeof(out) - len, "frames %lu  keyframes %lu  dropped %lu  %.1f bytes/frame\x1b[K\n",
+                    (unsigned long)decoder.frames, (unsigned long)decoder.keyframes,
+                    (unsigned long)decoder.dropped, decoder.frames ? (double)bytes / decoder.frames : 0.0);
+    fwrite(out, 1, len, stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    int fd = 0;
+    if (argc > 1) {
+        fd = open(argv[1], O_RDONLY | O_NOCTTY);
+        if (fd < 0) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    configure_serial(fd);
+
+    static FrameStreamDecoder decoder;
+    frame_stream_decoder_init(decoder);
+    printf("\x1b[2J");
+
+    uint8_t buf[512];
+    unsigned long bytes = 0;
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        bytes += n;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (frame_stream_decode_byte(decoder, buf[i])) {
+                draw_frame(decoder, bytes);
+            }
+        }
+    }
+    return 0;
+}
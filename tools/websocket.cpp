@@ -0,0 +1,176 @@
+#include "websocket.h"
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+// --- SHA-1 ---
+static uint32_t rol32(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+static void sha1_block(uint32_t h[5], const uint8_t* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+               (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; ++i) w[i] = rol32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = rol32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rol32(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+void sha1(const uint8_t* data, size_t len, uint8_t digest[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t full = len & ~(size_t)63;
+    for (size_t i = 0; i < full; i += 64) sha1_block(h, data + i);
+
+    // Padding: 0x80, zeros, then the bit length big-endian in the last 8 bytes
+    uint8_t tail[128];
+    size_t rest = len - full;
+    memcpy(tail, data + full, rest);
+    tail[rest] = 0x80;
+    size_t tail_len = rest + 1 + 8 <= 64 ? 64 : 128;
+    memset(tail + rest + 1, 0, tail_len - rest - 1);
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; ++i) tail[tail_len - 1 - i] = (uint8_t)(bits >> (i * 8));
+    for (size_t i = 0; i < tail_len; i += 64) sha1_block(h, tail + i);
+
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4] = (uint8_t)(h[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)h[i];
+    }
+}
+
+// --- Base64 ---
+int base64_encode(const uint8_t* data, size_t len, char* out) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int n = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out[n++] = ALPHABET[(v >> 18) & 63];
+        out[n++] = ALPHABET[(v >> 12) & 63];
+        out[n++] = i + 1 < len ? ALPHABET[(v >> 6) & 63] : '=';
+        out[n++] = i + 2 < len ? ALPHABET[v & 63] : '=';
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// --- Handshake ---
+void ws_accept_key(const char* key, char accept[WS_ACCEPT_LENGTH + 1]) {
+    static const char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    uint8_t buf[128];
+    size_t key_len = strlen(key);
+    if (key_len > sizeof(buf) - (sizeof(GUID) - 1)) key_len = sizeof(buf) - (sizeof(GUID) - 1);
+    memcpy(buf, key, key_len);
+    memcpy(buf + key_len, GUID, sizeof(GUID) - 1);
+    uint8_t digest[20];
+    sha1(buf, key_len + sizeof(GUID) - 1, digest);
+    base64_encode(digest, sizeof(digest), accept);
+}
+
+bool http_header_value(const char* message, const char* name, char* out, size_t size) {
+    size_t name_len = strlen(name);
+    for (const char* line = strstr(message, "\r\n"); line; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, name, name_len) != 0 || line[name_len] != ':') continue;
+        const char* value = line + name_len + 1;
+        while (*value == ' ' || *value == '\t') value++;
+        const char* end = strstr(value, "\r\n");
+        if (!end) end = value + strlen(value);
+        while (end > value && (end[-1] == ' ' || end[-1] == '\t')) end--;
+        size_t len = (size_t)(end - value);
+        if (len + 1 > size) return false;
+        memcpy(out, value, len);
+        out[len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+// --- Frames ---
+int ws_write_header(uint8_t* out, uint8_t opcode, uint64_t payload_len, const uint8_t* mask) {
+    int n = 0;
+    out[n++] = 0x80 | (opcode & 0x0F);
+    uint8_t mask_bit = mask ? 0x80 : 0;
+    if (payload_len < 126) {
+        out[n++] = mask_bit | (uint8_t)payload_len;
+    } else if (payload_len <= 0xFFFF) {
+        out[n++] = mask_bit | 126;
+        out[n++] = (uint8_t)(payload_len >> 8);
+        out[n++] = (uint8_t)payload_len;
+    } else {
+        out[n++] = mask_bit | 127;
+        for (int i = 7; i >= 0; --i) out[n++] = (uint8_t)(payload_len >> (i * 8));
+    }
+    if (mask) {
+        memcpy(out + n, mask, 4);
+        n += 4;
+    }
+    return n;
+}
+
+bool ws_parse_header(const uint8_t* data, size_t len, WsFrameHeader& header) {
+    if (len < 2) return false;
+    header.fin = (data[0] & 0x80) != 0;
+    header.opcode = data[0] & 0x0F;
+    header.masked = (data[1] & 0x80) != 0;
+    uint64_t payload_len = data[1] & 0x7F;
+    size_t n = 2;
+    if (payload_len == 126) {
+        if (len < n + 2) return false;
+        payload_len = (uint64_t)data[2] << 8 | data[3];
+        n += 2;
+    } else if (payload_len == 127) {
+        if (len < n + 8) return false;
+        payload_len = 0;
+        for (int i = 0; i < 8; ++i) payload_len = payload_len << 8 | data[n + i];
+        n += 8;
+    }
+    if (header.masked) {
+        if (len < n + 4) return false;
+        memcpy(header.mask, data + n, 4);
+        n += 4;
+    }
+    header.payload_len = payload_len;
+    header.header_len = (int)n;
+    return true;
+}
+
+// --- Clock ---
+uint32_t spectator_clock_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
@@ -0,0 +1,64 @@
+#ifndef WEBSOCKET_H
+#define WEBSOCKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Minimal WebSocket (RFC 6455) helpers for the spectator tools ---
+//
+// Just enough for spectator_server and spectator_load: the opening handshake,
+// frame headers in both directions and HTTP header lookup. No extensions, no
+// fragmentation (every message the tools send fits in one frame).
+
+#define WS_OPCODE_CONTINUATION 0x0
+#define WS_OPCODE_TEXT 0x1
+#define WS_OPCODE_BINARY 0x2
+#define WS_OPCODE_CLOSE 0x8
+#define WS_OPCODE_PING 0x9
+#define WS_OPCODE_PONG 0xA
+#define WS_MAX_HEADER 14   // 2 + 8 length bytes + 4 mask bytes
+#define WS_KEY_LENGTH 24   // Base64 of the 16-byte client nonce
+#define WS_ACCEPT_LENGTH 28 // Base64 of a SHA-1 digest
+
+struct WsFrameHeader {
+    uint8_t opcode;
+    bool fin;
+    bool masked;
+    uint8_t mask[4];
+    uint64_t payload_len;
+    int header_len;
+};
+
+void sha1(const uint8_t* data, size_t len, uint8_t digest[20]);
+
+// Writes NUL-terminated base64 to out (4 * ceil(len / 3) + 1 bytes) and returns its length
+int base64_encode(const uint8_t* data, size_t len, char* out);
+
+// Sec-WebSocket-Accept for a Sec-WebSocket-Key
+void ws_accept_key(const char* key, char accept[WS_ACCEPT_LENGTH + 1]);
+
+// Writes a FIN frame header and returns its length. Clients must pass a mask
+// and XOR the payload with it themselves; servers pass NULL.
+int ws_write_header(uint8_t* out, uint8_t opcode, uint64_t payload_len, const uint8_t* mask);
+
+// Parses the frame header at the start of data. Returns false if more bytes are needed.
+bool ws_parse_header(const uint8_t* data, size_t len, WsFrameHeader& header);
+
+// Copies the value of header `name` (case-insensitive) from an HTTP request or
+// response into out. Returns false if it is missing or does not fit.
+bool http_header_value(const char* message, const char* name, char* out, size_t size);
+
+// --- Spectator message layout ---
+// Every binary message from spectator_server is one frame stream packet
+// (src/frame_stream.h) behind this header:
+//   frame   uint32 LE  frame number since the server started
+//   ingest  uint32 LE  server CLOCK_MONOTONIC in us when the frame arrived
+// Local viewers on the same host subtract `ingest` from their own clock to get
+// the ingest-to-viewer latency.
+#define SPECTATOR_HEADER_SIZE 8
+#define SPECTATOR_DEFAULT_PORT 8090
+#define SPECTATOR_PATH "/ws"
+
+uint32_t spectator_clock_us(); // CLOCK_MONOTONIC, wraps every ~71 minutes
+
+#endif // WEBSOCKET_H